@@ -1,5 +1,6 @@
 // swift-tools-version: 6.0
 
+import CompilerPluginSupport
 import PackageDescription
 
 let package = Package(
@@ -18,6 +19,9 @@ let package = Package(
             targets: ["TOML"]
         )
     ],
+    dependencies: [
+        .package(url: "https://github.com/swiftlang/swift-syntax.git", "600.0.0" ..< "603.0.0")
+    ],
     targets: [
         .target(
             name: "CTomlPlusPlus",
@@ -28,14 +32,28 @@ let package = Package(
                 .headerSearchPath(".")
             ]
         ),
+        .macro(
+            name: "TOMLMacros",
+            dependencies: [
+                .product(name: "SwiftCompilerPlugin", package: "swift-syntax"),
+                .product(name: "SwiftSyntaxMacros", package: "swift-syntax"),
+            ]
+        ),
         .target(
             name: "TOML",
-            dependencies: ["CTomlPlusPlus"]
+            dependencies: ["CTomlPlusPlus", "TOMLMacros"]
         ),
         .testTarget(
             name: "TOMLTests",
             dependencies: ["TOML"]
         ),
+        .testTarget(
+            name: "TOMLMacrosTests",
+            dependencies: [
+                "TOMLMacros",
+                .product(name: "SwiftSyntaxMacrosGenericTestSupport", package: "swift-syntax"),
+            ]
+        ),
     ],
     cxxLanguageStandard: .cxx17
 )
@@ -4,12 +4,21 @@
 #include "include/ctoml.h"
 #include "toml.hpp"
 #include <exception>
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <limits>
 #include <list>
 #include <new>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 // Forward declaration
@@ -61,6 +70,20 @@ struct CTomlTable
 		return static_cast<CTomlString*>(mem);
 	}
 
+	// Allocate an array of entry indices
+	size_t* alloc_indices(size_t count)
+	{
+		if (count == 0)
+			return nullptr;
+		void* mem = std::malloc(count * sizeof(size_t));
+		if (!mem)
+		{
+			throw std::bad_alloc();
+		}
+		allocations.push_back(mem);
+		return static_cast<size_t*>(mem);
+	}
+
 	~CTomlTable()
 	{
 		for (void* ptr : allocations)
@@ -70,6 +93,57 @@ struct CTomlTable
 	}
 };
 
+// Days since 1970-01-01 in the proleptic Gregorian calendar
+// (Howard Hinnant's days_from_civil algorithm).
+static int64_t days_from_civil(int64_t year, int64_t month, int64_t day)
+{
+	year -= month <= 2 ? 1 : 0;
+	const int64_t era = (year >= 0 ? year : year - 399) / 400;
+	const int64_t yoe = year - era * 400;
+	const int64_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+	const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + doe - 719468;
+}
+
+// Inverse of days_from_civil (Howard Hinnant's civil_from_days algorithm).
+static void civil_from_days(int64_t days, int64_t* year, int64_t* month, int64_t* day)
+{
+	days += 719468;
+	const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+	const int64_t doe = days - era * 146097;
+	const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	const int64_t mp  = (5 * doy + 2) / 153;
+	*day			  = doy - (153 * mp + 2) / 5 + 1;
+	*month			  = mp < 10 ? mp + 3 : mp - 9;
+	*year			  = yoe + era * 400 + (*month <= 2 ? 1 : 0);
+}
+
+// Returns the indices of a table's entries in the order their keys appear in the document,
+// or null if that's the same as the table's key order.
+static size_t* document_order(const std::vector<const toml::key*>& keys, CTomlTable* storage)
+{
+	bool sorted = true;
+	for (size_t i = 1; sorted && i < keys.size(); i++)
+	{
+		sorted = !(keys[i]->source().begin < keys[i - 1]->source().begin);
+	}
+	if (sorted)
+	{
+		return nullptr;
+	}
+
+	size_t* order = storage->alloc_indices(keys.size());
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		order[i] = i;
+	}
+	std::stable_sort(order,
+					 order + keys.size(),
+					 [&](size_t lhs, size_t rhs) { return keys[lhs]->source().begin < keys[rhs]->source().begin; });
+	return order;
+}
+
 static CTomlNode convert_table(const toml::table& table, CTomlTable* storage)
 {
 	CTomlNode result{};
@@ -81,13 +155,138 @@ static CTomlNode convert_table(const toml::table& table, CTomlTable* storage)
 	result.data.table_value.keys   = storage->alloc_keys(count);
 	result.data.table_value.values = storage->alloc_nodes(count);
 
+	std::vector<const toml::key*> keys;
+	keys.reserve(count);
 	size_t i = 0;
 	for (auto& [k, v] : table)
 	{
+		keys.push_back(&k);
 		result.data.table_value.keys[i]	  = storage->store_string(std::string(k));
 		result.data.table_value.values[i] = convert_node(v, storage);
 		i++;
 	}
+	result.data.table_value.order = document_order(keys, storage);
+
+	return result;
+}
+
+// Thrown when part of a document breaks one of its limits.
+// The messages match the ones TOMLDecoder uses for the converted tree.
+struct limit_error : std::runtime_error
+{
+	using std::runtime_error::runtime_error;
+};
+
+// Checks `node` and everything below it against `limits`, the way TOMLDecoder
+// checks the converted tree. Returns false if a string has more bytes and
+// Unicode scalars than allowed: its characters can only be counted by the caller.
+static bool check_limits(const toml::node& node, const CTomlLimits& limits, int64_t depth)
+{
+	if (depth >= limits.max_depth)
+	{
+		throw limit_error("Maximum nesting depth of " + std::to_string(limits.max_depth) + " exceeded");
+	}
+
+	if (auto* str = node.as_string())
+	{
+		const std::string& value = str->get();
+		if (static_cast<int64_t>(value.size()) <= limits.max_string_length)
+		{
+			return true;
+		}
+		int64_t scalars = 0;
+		for (unsigned char c : value)
+		{
+			scalars += (c & 0xC0) != 0x80;
+		}
+		return scalars <= limits.max_string_length;
+	}
+
+	bool checked = true;
+	if (auto* arr = node.as_array())
+	{
+		if (static_cast<int64_t>(arr->size()) > limits.max_array_length)
+		{
+			throw limit_error("Array exceeds maximum length of " + std::to_string(limits.max_array_length)
+							  + " elements");
+		}
+		for (auto& elem : *arr)
+		{
+			checked = check_limits(elem, limits, depth + 1) && checked;
+		}
+	}
+	else if (auto* tbl = node.as_table())
+	{
+		if (static_cast<int64_t>(tbl->size()) > limits.max_table_keys)
+		{
+			throw limit_error("Table exceeds maximum of " + std::to_string(limits.max_table_keys) + " keys");
+		}
+		for (auto& [k, v] : *tbl)
+		{
+			checked = check_limits(v, limits, depth + 1) && checked;
+		}
+	}
+	return checked;
+}
+
+// Converts only the entries of `table` whose keys appear in `selected`,
+// keeping the table's key order. The other entries are checked against `limits`,
+// and converted too if only the caller can finish checking them.
+static CTomlNode convert_selected_entries(const toml::table& table,
+										  const CTomlString* selected,
+										  size_t selected_count,
+										  const CTomlLimits* limits,
+										  CTomlTable* storage)
+{
+	if (limits)
+	{
+		if (limits->max_depth <= 0)
+		{
+			throw limit_error("Maximum nesting depth of " + std::to_string(limits->max_depth) + " exceeded");
+		}
+		if (static_cast<int64_t>(table.size()) > limits->max_table_keys)
+		{
+			throw limit_error("Table exceeds maximum of " + std::to_string(limits->max_table_keys) + " keys");
+		}
+	}
+
+	std::vector<std::pair<const toml::key*, const toml::node*>> entries;
+	entries.reserve(selected_count);
+	for (auto& [k, v] : table)
+	{
+		bool is_selected = false;
+		for (size_t j = 0; j < selected_count; ++j)
+		{
+			if (k.str() == std::string_view(selected[j].data, selected[j].length))
+			{
+				is_selected = true;
+				break;
+			}
+		}
+		if (is_selected || (limits && !check_limits(v, *limits, 1)))
+		{
+			entries.emplace_back(&k, &v);
+		}
+	}
+
+	CTomlNode result{};
+	result.type = CTOML_TABLE;
+
+	size_t count = entries.size();
+
+	result.data.table_value.count  = count;
+	result.data.table_value.keys   = storage->alloc_keys(count);
+	result.data.table_value.values = storage->alloc_nodes(count);
+
+	std::vector<const toml::key*> keys;
+	keys.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		keys.push_back(entries[i].first);
+		result.data.table_value.keys[i]	  = storage->store_string(std::string(*entries[i].first));
+		result.data.table_value.values[i] = convert_node(*entries[i].second, storage);
+	}
+	result.data.table_value.order = document_order(keys, storage);
 
 	return result;
 }
@@ -173,6 +372,15 @@ static CTomlNode convert_node(const toml::node& node, CTomlTable* storage)
 		result.data.datetime_value.time.nanosecond = static_cast<int32_t>(dt.time.nanosecond);
 		result.data.datetime_value.has_offset	   = dt.offset.has_value();
 		result.data.datetime_value.offset_minutes  = result.data.datetime_value.has_offset ? dt.offset->minutes : 0;
+		if (result.data.datetime_value.has_offset)
+		{
+			const int64_t days = days_from_civil(dt.date.year, dt.date.month, dt.date.day);
+			const int64_t seconds_of_day
+				= int64_t{ dt.time.hour } * 3600 + int64_t{ dt.time.minute } * 60 + int64_t{ dt.time.second };
+			result.data.datetime_value.epoch_seconds
+				= days * 86400 + seconds_of_day - int64_t{ result.data.datetime_value.offset_minutes } * 60;
+			result.data.datetime_value.epoch_nanoseconds = static_cast<int32_t>(dt.time.nanosecond);
+		}
 	}
 	else if (node.is_array())
 	{
@@ -186,92 +394,1330 @@ static CTomlNode convert_node(const toml::node& node, CTomlTable* storage)
 	return result;
 }
 
-extern "C"
+static CTomlParseResult parse(const char* input,
+							  size_t length,
+							  const CTomlString* root_keys,
+							  size_t root_key_count,
+							  const CTomlLimits* limits,
+							  bool select_root_keys)
 {
-	CTomlParseResult ctoml_parse(const char* input, size_t length)
+	CTomlParseResult result{};
+	result.success		 = false;
+	result.error_message = nullptr;
+	result.error_line	 = 0;
+	result.error_column	 = 0;
+	result.handle		 = nullptr;
+	result.root.type	 = CTOML_NONE;
+
+	try
 	{
-		CTomlParseResult result{};
-		result.success		 = false;
-		result.error_message = nullptr;
-		result.error_line	 = 0;
-		result.error_column	 = 0;
-		result.handle		 = nullptr;
-		result.root.type	 = CTOML_NONE;
+		CTomlTable* storage = new CTomlTable();
+		result.handle		= storage;
 
-		try
+		std::string_view sv(input, length);
+		auto table = toml::parse(sv);
+		if (select_root_keys)
+		{
+			result.root = convert_selected_entries(table, root_keys, root_key_count, limits, storage);
+		}
+		else
+		{
+			result.root = convert_table(table, storage);
+		}
+		result.success = true;
+	}
+	catch (const toml::parse_error& err)
+	{
+		if (result.handle)
+		{
+			result.handle->error_message = std::string(err.description());
+			result.error_message		 = result.handle->error_message.c_str();
+		}
+		result.error_line	= err.source().begin.line;
+		result.error_column = err.source().begin.column;
+		result.root.type	= CTOML_NONE;
+	}
+	catch (const std::exception& err)
+	{
+		if (result.handle)
+		{
+			result.handle->error_message = std::string(err.what());
+			result.error_message		 = result.handle->error_message.c_str();
+		}
+		else
+		{
+			// Best effort if allocation failed before we created a handle.
+			if (dynamic_cast<const std::bad_alloc*>(&err))
+			{
+				result.error_message = "Out of memory";
+			}
+			else
+			{
+				result.error_message = "Unknown error";
+			}
+		}
+		result.error_line	= 0;
+		result.error_column = 0;
+		result.root.type	= CTOML_NONE;
+	}
+	catch (...)
+	{
+		if (result.handle)
+		{
+			result.handle->error_message = "Unknown error";
+			result.error_message		 = result.handle->error_message.c_str();
+		}
+		else
+		{
+			result.error_message = "Unknown error";
+		}
+		result.error_line	= 0;
+		result.error_column = 0;
+		result.root.type	= CTOML_NONE;
+	}
+
+	return result;
+}
+
+// Document builder: a toml++ table assembled from a sequence of calls,
+// with a stack of the tables and arrays still being filled in.
+struct CTomlBuilder
+{
+	toml::table root;
+	std::vector<toml::node*> stack{ &root };
+	std::string key;
+	bool has_key = false;
+	bool failed	 = false;
+
+	// Inserts `value` into the innermost open container and returns the inserted node.
+	template <typename T>
+	toml::node* insert(T&& value)
+	{
+		if (failed || stack.empty())
+		{
+			failed = true;
+			return nullptr;
+		}
+		toml::node* parent = stack.back();
+		if (auto* table = parent->as_table())
+		{
+			if (!has_key)
+			{
+				failed = true;
+				return nullptr;
+			}
+			has_key	 = false;
+			auto res = table->insert_or_assign(key, std::forward<T>(value));
+			return &res.first->second;
+		}
+		auto* array = parent->as_array();
+		array->push_back(std::forward<T>(value));
+		return &array->back();
+	}
+};
+
+// Appends bytes to a CTomlBuffer, growing it geometrically.
+// Returns false if memory ran out, leaving the buffer unchanged.
+static bool buffer_append(CTomlBuffer* buffer, const char* data, size_t count)
+{
+	if (buffer->capacity - buffer->length < count)
+	{
+		size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+		while (capacity - buffer->length < count)
+		{
+			capacity *= 2;
+		}
+		void* grown = std::realloc(buffer->data, capacity);
+		if (!grown)
+		{
+			return false;
+		}
+		buffer->data	 = static_cast<char*>(grown);
+		buffer->capacity = capacity;
+	}
+	if (count > 0)
+	{
+		std::memcpy(buffer->data + buffer->length, data, count);
+		buffer->length += count;
+	}
+	return true;
+}
+
+// Appends formatter output to a CTomlBuffer.
+class buffer_streambuf : public std::streambuf
+{
+	CTomlBuffer* buffer;
+
+	void append(const char* data, size_t count)
+	{
+		if (!buffer_append(buffer, data, count))
+		{
+			throw std::bad_alloc();
+		}
+	}
+
+  protected:
+	int_type overflow(int_type ch) override
+	{
+		if (!traits_type::eq_int_type(ch, traits_type::eof()))
+		{
+			const char c = traits_type::to_char_type(ch);
+			append(&c, 1);
+		}
+		return traits_type::not_eof(ch);
+	}
+
+	std::streamsize xsputn(const char* data, std::streamsize count) override
+	{
+		append(data, static_cast<size_t>(count));
+		return count;
+	}
+
+  public:
+	explicit buffer_streambuf(CTomlBuffer* buffer) : buffer(buffer)
+	{
+	}
+};
+
+static bool make_date(CTomlDate value, toml::date* date)
+{
+	if (value.year < 0 || value.year > 9999 || value.month < 1 || value.month > 12 || value.day < 1 || value.day > 31)
+	{
+		return false;
+	}
+	*date = toml::date{ value.year, value.month, value.day };
+	return true;
+}
+
+static bool make_time(CTomlTime value, toml::time* time)
+{
+	if (value.hour < 0 || value.hour > 23 || value.minute < 0 || value.minute > 59 || value.second < 0
+		|| value.second > 60 || value.nanosecond < 0 || value.nanosecond > 999999999)
+	{
+		return false;
+	}
+	*time = toml::time{ value.hour, value.minute, value.second, static_cast<uint32_t>(value.nanosecond) };
+	return true;
+}
+
+// Writes parsed nodes as toml-test's tagged JSON, where every value is an object
+// with its TOML type and its value as a string, such as {"type":"integer","value":"1"}.
+struct tagged_json_writer
+{
+	CTomlBuffer* buffer;
+	bool ok = true;
+
+	void write(const char* data, size_t count)
+	{
+		ok = ok && buffer_append(buffer, data, count);
+	}
+
+	void write(const char* text)
+	{
+		write(text, std::strlen(text));
+	}
+
+	void write_format(const char* format, ...)
+	{
+		char scratch[64];
+		va_list args;
+		va_start(args, format);
+		const int count = std::vsnprintf(scratch, sizeof(scratch), format, args);
+		va_end(args);
+		if (count > 0)
+		{
+			write(scratch, std::min(static_cast<size_t>(count), sizeof(scratch) - 1));
+		}
+	}
+
+	void write_string(const char* data, size_t length)
+	{
+		write("\"");
+		size_t start = 0;
+		for (size_t i = 0; i < length; i++)
 		{
-			CTomlTable* storage = new CTomlTable();
-			result.handle		= storage;
+			const unsigned char c = static_cast<unsigned char>(data[i]);
+			if (c >= 0x20 && c != '"' && c != '\\')
+			{
+				continue;
+			}
+			write(data + start, i - start);
+			start = i + 1;
+			switch (c)
+			{
+				case '"':
+					write("\\\"");
+					break;
+				case '\\':
+					write("\\\\");
+					break;
+				case '\n':
+					write("\\n");
+					break;
+				case '\r':
+					write("\\r");
+					break;
+				case '\t':
+					write("\\t");
+					break;
+				default:
+					write_format("\\u%04X", c);
+					break;
+			}
+		}
+		write(data + start, length - start);
+		write("\"");
+	}
+
+	void write_tagged(const char* type)
+	{
+		write("{\"type\":\"");
+		write(type);
+		write("\",\"value\":\"");
+	}
 
-			std::string_view sv(input, length);
-			auto table	   = toml::parse(sv);
-			result.root	   = convert_table(table, storage);
-			result.success = true;
+	void write_float(double value)
+	{
+		if (std::isnan(value))
+		{
+			write("nan");
+		}
+		else if (std::isinf(value))
+		{
+			write(value > 0 ? "inf" : "-inf");
 		}
-		catch (const toml::parse_error& err)
+		else if (value == std::floor(value) && std::fabs(value) < 1e15)
 		{
-			if (result.handle)
+			write_format("%.1f", value);
+		}
+		else
+		{
+			// The shortest precision that reads back as the same value.
+			char scratch[32];
+			for (int precision = 1; precision <= 17; precision++)
 			{
-				result.handle->error_message = std::string(err.description());
-				result.error_message		 = result.handle->error_message.c_str();
+				std::snprintf(scratch, sizeof(scratch), "%.*g", precision, value);
+				if (std::strtod(scratch, nullptr) == value)
+				{
+					break;
+				}
 			}
-			result.error_line	= err.source().begin.line;
-			result.error_column = err.source().begin.column;
-			result.root.type	= CTOML_NONE;
+			write(scratch);
+		}
+	}
+
+	void write_time(int32_t hour, int32_t minute, int32_t second, int32_t nanosecond)
+	{
+		write_format("%02d:%02d:%02d", hour, minute, second);
+		if (nanosecond > 0)
+		{
+			write_format(".%03d", nanosecond / 1000000);
 		}
-		catch (const std::exception& err)
+	}
+
+	void write_node(const CTomlNode& node)
+	{
+		switch (node.type)
 		{
-			if (result.handle)
+			case CTOML_NONE:
+				write_tagged("string");
+				write("\"}");
+				break;
+
+			case CTOML_STRING:
+				write("{\"type\":\"string\",\"value\":");
+				write_string(node.data.string_value.data, node.data.string_value.length);
+				write("}");
+				break;
+
+			case CTOML_INTEGER:
+				write_tagged("integer");
+				write_format("%lld", static_cast<long long>(node.data.integer_value));
+				write("\"}");
+				break;
+
+			case CTOML_FLOAT:
+				write_tagged("float");
+				write_float(node.data.float_value);
+				write("\"}");
+				break;
+
+			case CTOML_BOOLEAN:
+				write_tagged("bool");
+				write(node.data.boolean_value ? "true" : "false");
+				write("\"}");
+				break;
+
+			case CTOML_DATE:
 			{
-				result.handle->error_message = std::string(err.what());
-				result.error_message		 = result.handle->error_message.c_str();
+				const CTomlDate& d = node.data.date_value;
+				write_tagged("date-local");
+				write_format("%04d-%02d-%02d", d.year, d.month, d.day);
+				write("\"}");
+				break;
 			}
-			else
+
+			case CTOML_TIME:
 			{
-				// Best effort if allocation failed before we created a handle.
-				if (dynamic_cast<const std::bad_alloc*>(&err))
+				const CTomlTime& t = node.data.time_value;
+				write_tagged("time-local");
+				write_time(t.hour, t.minute, t.second, t.nanosecond);
+				write("\"}");
+				break;
+			}
+
+			case CTOML_DATETIME:
+			{
+				const CTomlDateTime& dt = node.data.datetime_value;
+				if (dt.has_offset)
 				{
-					result.error_message = "Out of memory";
+					// Offset date-times are written in UTC, with millisecond precision.
+					const int64_t seconds	 = dt.epoch_seconds;
+					const int64_t days		 = (seconds >= 0 ? seconds : seconds - 86399) / 86400;
+					const int64_t second_day = seconds - days * 86400;
+					int64_t year, month, day;
+					civil_from_days(days, &year, &month, &day);
+					write_tagged("datetime");
+					write_format("%04lld-%02lld-%02lldT%02lld:%02lld:%02lld.%03d",
+								 static_cast<long long>(year),
+								 static_cast<long long>(month),
+								 static_cast<long long>(day),
+								 static_cast<long long>(second_day / 3600),
+								 static_cast<long long>(second_day % 3600 / 60),
+								 static_cast<long long>(second_day % 60),
+								 dt.epoch_nanoseconds / 1000000);
+					write("Z\"}");
 				}
 				else
 				{
-					result.error_message = "Unknown error";
+					write_tagged("datetime-local");
+					write_format("%04d-%02d-%02dT", dt.date.year, dt.date.month, dt.date.day);
+					write_time(dt.time.hour, dt.time.minute, dt.time.second, dt.time.nanosecond);
+					write("\"}");
 				}
+				break;
 			}
-			result.error_line	= 0;
-			result.error_column = 0;
-			result.root.type	= CTOML_NONE;
-		}
-		catch (...)
-		{
-			if (result.handle)
+
+			case CTOML_ARRAY:
 			{
-				result.handle->error_message = "Unknown error";
-				result.error_message		 = result.handle->error_message.c_str();
+				const CTomlArrayData& array = node.data.array_value;
+				write("[");
+				for (size_t i = 0; i < array.count; i++)
+				{
+					if (i > 0)
+					{
+						write(",");
+					}
+					write_node(array.elements[i]);
+				}
+				write("]");
+				break;
 			}
-			else
+
+			case CTOML_TABLE:
 			{
-				result.error_message = "Unknown error";
+				// Keys are already in byte-wise order.
+				const CTomlTableData& table = node.data.table_value;
+				write("{");
+				for (size_t i = 0; i < table.count; i++)
+				{
+					if (i > 0)
+					{
+						write(",");
+					}
+					write_string(table.keys[i].data, table.keys[i].length);
+					write(":");
+					write_node(table.values[i]);
+				}
+				write("}");
+				break;
 			}
-			result.error_line	= 0;
-			result.error_column = 0;
-			result.root.type	= CTOML_NONE;
 		}
-
-		return result;
 	}
+};
 
-	void ctoml_free_result(CTomlParseResult* result)
+// Adds a parsed node, and everything in it, to the innermost open container of `builder`.
+// The formatters work on toml++ nodes, so parsed documents are rebuilt from the C tree.
+static void rebuild_node(CTomlBuilder& builder, const CTomlNode& node)
+{
+	switch (node.type)
 	{
-		if (!result)
+		case CTOML_NONE:
+			builder.insert(std::string());
+			break;
+
+		case CTOML_STRING:
+			builder.insert(std::string(node.data.string_value.data, node.data.string_value.length));
+			break;
+
+		case CTOML_INTEGER:
+			builder.insert(node.data.integer_value);
+			break;
+
+		case CTOML_FLOAT:
+			builder.insert(node.data.float_value);
+			break;
+
+		case CTOML_BOOLEAN:
+			builder.insert(node.data.boolean_value);
+			break;
+
+		case CTOML_DATE:
 		{
-			return;
+			toml::date date;
+			builder.failed = builder.failed || !make_date(node.data.date_value, &date);
+			builder.insert(date);
+			break;
 		}
 
-		if (result->handle)
+		case CTOML_TIME:
 		{
-			delete result->handle;
-			result->handle = nullptr;
+			toml::time time;
+			builder.failed = builder.failed || !make_time(node.data.time_value, &time);
+			builder.insert(time);
+			break;
+		}
+
+		case CTOML_DATETIME:
+		{
+			const CTomlDateTime& value = node.data.datetime_value;
+			toml::date date;
+			toml::time time;
+			builder.failed = builder.failed || !make_date(value.date, &date) || !make_time(value.time, &time);
+			if (value.has_offset)
+			{
+				builder.insert(toml::date_time{ date, time, toml::time_offset{ 0, value.offset_minutes } });
+			}
+			else
+			{
+				builder.insert(toml::date_time{ date, time });
+			}
+			break;
+		}
+
+		case CTOML_ARRAY:
+		{
+			const CTomlArrayData& array = node.data.array_value;
+			auto* inserted				= builder.insert(toml::array{});
+			if (!inserted)
+			{
+				break;
+			}
+			inserted->as_array()->reserve(array.count);
+			builder.stack.push_back(inserted);
+			for (size_t i = 0; i < array.count; i++)
+			{
+				rebuild_node(builder, array.elements[i]);
+			}
+			builder.stack.pop_back();
+			break;
+		}
+
+		case CTOML_TABLE:
+		{
+			const CTomlTableData& table = node.data.table_value;
+			auto* inserted				= builder.insert(toml::table{});
+			if (!inserted)
+			{
+				break;
+			}
+			builder.stack.push_back(inserted);
+			for (size_t i = 0; i < table.count; i++)
+			{
+				builder.key.assign(table.keys[i].data, table.keys[i].length);
+				builder.has_key = true;
+				rebuild_node(builder, table.values[i]);
+			}
+			builder.stack.pop_back();
+			break;
+		}
+	}
+}
+
+static_assert(CTOML_FORMAT_QUOTE_DATES_AND_TIMES
+				  == static_cast<CTomlFormatFlags>(toml::format_flags::quote_dates_and_times),
+			  "CTomlFormatFlags must match toml::format_flags");
+static_assert(CTOML_FORMAT_FORCE_MULTILINE_ARRAYS
+				  == static_cast<CTomlFormatFlags>(toml::format_flags::force_multiline_arrays),
+			  "CTomlFormatFlags must match toml::format_flags");
+
+// Passes formatter output to a caller's write callback in chunks.
+class callback_streambuf : public std::streambuf
+{
+	CTomlWriteCallback write;
+	void* context;
+	char chunk[64 * 1024];
+
+	void write_chunk()
+	{
+		const size_t count = static_cast<size_t>(pptr() - pbase());
+		if (count > 0 && !write(context, pbase(), count))
+		{
+			// Stops the formatter; the stream reports it as a failure.
+			throw std::runtime_error("write callback failed");
+		}
+		setp(chunk, chunk + sizeof(chunk));
+	}
+
+  protected:
+	int_type overflow(int_type ch) override
+	{
+		write_chunk();
+		if (!traits_type::eq_int_type(ch, traits_type::eof()))
+		{
+			*pptr() = traits_type::to_char_type(ch);
+			pbump(1);
+		}
+		return traits_type::not_eof(ch);
+	}
+
+	int sync() override
+	{
+		write_chunk();
+		return 0;
+	}
+
+  public:
+	callback_streambuf(CTomlWriteCallback write, void* context) : write(write), context(context)
+	{
+		setp(chunk, chunk + sizeof(chunk));
+	}
+};
+
+// Parses the digits of a date or time field, returning false unless there are exactly `count` of them.
+static bool parse_digits(std::string_view text, size_t offset, size_t count, int32_t* value)
+{
+	if (offset + count > text.size())
+	{
+		return false;
+	}
+	*value = 0;
+	for (size_t i = offset; i < offset + count; i++)
+	{
+		if (text[i] < '0' || text[i] > '9')
+		{
+			return false;
+		}
+		*value = *value * 10 + (text[i] - '0');
+	}
+	return true;
+}
+
+// Parses a date written as YYYY-MM-DD.
+static bool parse_date(std::string_view text, toml::date* date)
+{
+	CTomlDate value{};
+	return text.size() == 10 && text[4] == '-' && text[7] == '-' && parse_digits(text, 0, 4, &value.year)
+		&& parse_digits(text, 5, 2, &value.month) && parse_digits(text, 8, 2, &value.day) && make_date(value, date);
+}
+
+// Parses a time written as HH:MM, HH:MM:SS, or HH:MM:SS followed by a fraction of a second.
+static bool parse_time(std::string_view text, toml::time* time)
+{
+	CTomlTime value{};
+	if (text.size() < 5 || text[2] != ':' || !parse_digits(text, 0, 2, &value.hour)
+		|| !parse_digits(text, 3, 2, &value.minute))
+	{
+		return false;
+	}
+	if (text.size() > 5)
+	{
+		if (text.size() < 8 || text[5] != ':' || !parse_digits(text, 6, 2, &value.second))
+		{
+			return false;
+		}
+		if (text.size() > 8)
+		{
+			// Digits past nanoseconds are dropped.
+			if (text[8] != '.' || text.size() == 9)
+			{
+				return false;
+			}
+			int32_t scale = 100000000;
+			for (size_t i = 9; i < text.size(); i++, scale /= 10)
+			{
+				if (text[i] < '0' || text[i] > '9')
+				{
+					return false;
+				}
+				value.nanosecond += (text[i] - '0') * scale;
+			}
+		}
+	}
+	return make_time(value, time);
+}
+
+// Parses a date-time written as a date and a time separated by 'T', 't', or a space,
+// followed by an offset of 'Z', 'z', or +HH:MM / -HH:MM when `with_offset` is set.
+static bool parse_date_time(std::string_view text, toml::date_time* date_time, bool with_offset)
+{
+	if (text.size() < 16 || (text[10] != 'T' && text[10] != 't' && text[10] != ' '))
+	{
+		return false;
+	}
+	std::string_view time_text = text.substr(11);
+	toml::time_offset offset;
+	if (with_offset)
+	{
+		if (time_text.back() == 'Z' || time_text.back() == 'z')
+		{
+			time_text.remove_suffix(1);
+		}
+		else
+		{
+			if (time_text.size() < 6)
+			{
+				return false;
+			}
+			int32_t hours, minutes;
+			const std::string_view offset_text = time_text.substr(time_text.size() - 6);
+			if ((offset_text[0] != '+' && offset_text[0] != '-') || offset_text[3] != ':'
+				|| !parse_digits(offset_text, 1, 2, &hours) || !parse_digits(offset_text, 4, 2, &minutes)
+				|| hours > 23 || minutes > 59)
+			{
+				return false;
+			}
+			const int32_t sign = offset_text[0] == '-' ? -1 : 1;
+			offset			   = toml::time_offset{ sign * hours, sign * minutes };
+			time_text.remove_suffix(6);
+		}
+	}
+
+	toml::date date;
+	toml::time time;
+	if (!parse_date(text.substr(0, 10), &date) || !parse_time(time_text, &time))
+	{
+		return false;
+	}
+	*date_time = with_offset ? toml::date_time{ date, time, offset } : toml::date_time{ date, time };
+	return true;
+}
+
+// Parses a whole string as a decimal integer.
+static bool parse_integer(std::string_view text, int64_t* value)
+{
+	size_t i			= 0;
+	const bool negative = !text.empty() && text[0] == '-';
+	if (!text.empty() && (text[0] == '-' || text[0] == '+'))
+	{
+		i++;
+	}
+	if (i == text.size())
+	{
+		return false;
+	}
+	// Accumulates negatively, so that INT64_MIN doesn't overflow.
+	int64_t result = 0;
+	for (; i < text.size(); i++)
+	{
+		if (text[i] < '0' || text[i] > '9')
+		{
+			return false;
+		}
+		const int digit = text[i] - '0';
+		if (result < (INT64_MIN + digit) / 10)
+		{
+			return false;
+		}
+		result = result * 10 - digit;
+	}
+	if (!negative && result == INT64_MIN)
+	{
+		return false;
+	}
+	*value = negative ? result : -result;
+	return true;
+}
+
+// Parses a whole string as a floating-point number, including nan and inf with an optional sign.
+static bool parse_float(std::string_view text, double* value)
+{
+	std::string_view magnitude = text;
+	if (!magnitude.empty() && (magnitude[0] == '+' || magnitude[0] == '-'))
+	{
+		magnitude.remove_prefix(1);
+	}
+	if (magnitude == "nan")
+	{
+		*value = std::numeric_limits<double>::quiet_NaN();
+		return true;
+	}
+	if (magnitude == "inf")
+	{
+		*value = text[0] == '-' ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+		return true;
+	}
+	if (text.empty())
+	{
+		return false;
+	}
+	// strtod needs a terminated string; JSON numbers can have any number of digits.
+	const std::string terminated(text);
+	char* end;
+	*value = std::strtod(terminated.c_str(), &end);
+	return end == terminated.c_str() + terminated.size();
+}
+
+// Reads JSON into a CTomlBuilder as it goes, without building a JSON tree first.
+// Objects become tables and arrays become arrays. Null members are left out,
+// like nil values in TOMLEncoder, and null array elements are rejected.
+// In tagged mode, objects with only string "type" and "value" members
+// are read as toml-test's tagged values.
+struct json_reader
+{
+	// Nesting beyond this depth is rejected, rather than risking the stack.
+	static constexpr int max_depth = 512;
+
+	CTomlBuilder& builder;
+	const char* const start;
+	const char* const end;
+	const bool tagged;
+	const char* p;
+	int depth = 0;
+
+	json_reader(CTomlBuilder& builder, const char* input, size_t length, bool tagged)
+		: builder(builder),
+		  start(input),
+		  end(input + length),
+		  tagged(tagged),
+		  p(input)
+	{
+	}
+
+	void skip_whitespace()
+	{
+		while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+		{
+			p++;
+		}
+	}
+
+	bool consume(char c)
+	{
+		skip_whitespace();
+		if (p < end && *p == c)
+		{
+			p++;
+			return true;
+		}
+		return false;
+	}
+
+	bool consume_literal(std::string_view literal)
+	{
+		if (static_cast<size_t>(end - p) < literal.size() || std::string_view(p, literal.size()) != literal)
+		{
+			return false;
+		}
+		p += literal.size();
+		return true;
+	}
+
+	static void append_utf8(std::string& out, uint32_t scalar)
+	{
+		if (scalar < 0x80)
+		{
+			out += static_cast<char>(scalar);
+		}
+		else if (scalar < 0x800)
+		{
+			out += static_cast<char>(0xC0 | (scalar >> 6));
+			out += static_cast<char>(0x80 | (scalar & 0x3F));
+		}
+		else if (scalar < 0x10000)
+		{
+			out += static_cast<char>(0xE0 | (scalar >> 12));
+			out += static_cast<char>(0x80 | ((scalar >> 6) & 0x3F));
+			out += static_cast<char>(0x80 | (scalar & 0x3F));
+		}
+		else
+		{
+			out += static_cast<char>(0xF0 | (scalar >> 18));
+			out += static_cast<char>(0x80 | ((scalar >> 12) & 0x3F));
+			out += static_cast<char>(0x80 | ((scalar >> 6) & 0x3F));
+			out += static_cast<char>(0x80 | (scalar & 0x3F));
+		}
+	}
+
+	bool read_hex4(uint32_t* value)
+	{
+		if (end - p < 4)
+		{
+			return false;
+		}
+		*value = 0;
+		for (int i = 0; i < 4; i++, p++)
+		{
+			const char c = *p;
+			*value <<= 4;
+			if (c >= '0' && c <= '9')
+				*value |= static_cast<uint32_t>(c - '0');
+			else if (c >= 'a' && c <= 'f')
+				*value |= static_cast<uint32_t>(c - 'a' + 10);
+			else if (c >= 'A' && c <= 'F')
+				*value |= static_cast<uint32_t>(c - 'A' + 10);
+			else
+				return false;
+		}
+		return true;
+	}
+
+	// Checks one UTF-8 encoded scalar starting at p, and advances past it.
+	bool skip_utf8_scalar()
+	{
+		const unsigned char lead = static_cast<unsigned char>(*p);
+		size_t count;
+		uint32_t scalar;
+		if (lead >= 0xC2 && lead <= 0xDF)
+		{
+			count  = 1;
+			scalar = lead & 0x1F;
+		}
+		else if (lead >= 0xE0 && lead <= 0xEF)
+		{
+			count  = 2;
+			scalar = lead & 0x0F;
+		}
+		else if (lead >= 0xF0 && lead <= 0xF4)
+		{
+			count  = 3;
+			scalar = lead & 0x07;
+		}
+		else
+		{
+			return false;
+		}
+		if (static_cast<size_t>(end - p) <= count)
+		{
+			return false;
+		}
+		for (size_t i = 1; i <= count; i++)
+		{
+			const unsigned char c = static_cast<unsigned char>(p[i]);
+			if ((c & 0xC0) != 0x80)
+			{
+				return false;
+			}
+			scalar = (scalar << 6) | (c & 0x3F);
+		}
+		// Rejects overlong encodings, surrogates, and scalars past U+10FFFF.
+		static constexpr uint32_t minimum[] = { 0, 0x80, 0x800, 0x10000 };
+		if (scalar < minimum[count] || (scalar >= 0xD800 && scalar <= 0xDFFF) || scalar > 0x10FFFF)
+		{
+			return false;
+		}
+		p += count + 1;
+		return true;
+	}
+
+	bool read_string(std::string& out)
+	{
+		out.clear();
+		if (!consume('"'))
+		{
+			return false;
+		}
+		const char* run = p;
+		while (p < end)
+		{
+			const unsigned char c = static_cast<unsigned char>(*p);
+			if (c == '"')
+			{
+				out.append(run, static_cast<size_t>(p - run));
+				p++;
+				return true;
+			}
+			if (c < 0x20)
+			{
+				return false;
+			}
+			if (c >= 0x80)
+			{
+				if (!skip_utf8_scalar())
+				{
+					return false;
+				}
+				continue;
+			}
+			if (c != '\\')
+			{
+				p++;
+				continue;
+			}
+
+			out.append(run, static_cast<size_t>(p - run));
+			if (++p == end)
+			{
+				return false;
+			}
+			switch (*p++)
+			{
+				case '"':
+					out += '"';
+					break;
+				case '\\':
+					out += '\\';
+					break;
+				case '/':
+					out += '/';
+					break;
+				case 'b':
+					out += '\b';
+					break;
+				case 'f':
+					out += '\f';
+					break;
+				case 'n':
+					out += '\n';
+					break;
+				case 'r':
+					out += '\r';
+					break;
+				case 't':
+					out += '\t';
+					break;
+				case 'u':
+				{
+					uint32_t scalar;
+					if (!read_hex4(&scalar) || (scalar >= 0xDC00 && scalar <= 0xDFFF))
+					{
+						return false;
+					}
+					if (scalar >= 0xD800 && scalar <= 0xDBFF)
+					{
+						uint32_t low;
+						if (!consume_literal("\\u") || !read_hex4(&low) || low < 0xDC00 || low > 0xDFFF)
+						{
+							return false;
+						}
+						scalar = 0x10000 + ((scalar - 0xD800) << 10) + (low - 0xDC00);
+					}
+					append_utf8(out, scalar);
+					break;
+				}
+				default:
+					return false;
+			}
+			run = p;
+		}
+		return false;
+	}
+
+	bool read_number()
+	{
+		const char* number = p;
+		bool integral	   = true;
+		if (p < end && *p == '-')
+		{
+			p++;
+		}
+		if (p == end || *p < '0' || *p > '9')
+		{
+			return false;
+		}
+		if (*p == '0')
+		{
+			p++;
+		}
+		else
+		{
+			while (p < end && *p >= '0' && *p <= '9')
+				p++;
+		}
+		if (p < end && *p == '.')
+		{
+			integral = false;
+			if (++p == end || *p < '0' || *p > '9')
+			{
+				return false;
+			}
+			while (p < end && *p >= '0' && *p <= '9')
+				p++;
+		}
+		if (p < end && (*p == 'e' || *p == 'E'))
+		{
+			integral = false;
+			if (++p < end && (*p == '+' || *p == '-'))
+			{
+				p++;
+			}
+			if (p == end || *p < '0' || *p > '9')
+			{
+				return false;
+			}
+			while (p < end && *p >= '0' && *p <= '9')
+				p++;
+		}
+
+		// Integers too large for 64 bits are read as floats.
+		const std::string_view text(number, static_cast<size_t>(p - number));
+		int64_t integer;
+		if (integral && parse_integer(text, &integer))
+		{
+			builder.insert(integer);
+			return true;
+		}
+		double value;
+		if (!parse_float(text, &value))
+		{
+			return false;
+		}
+		builder.insert(value);
+		return true;
+	}
+
+	// Inserts the value of a tagged object, such as {"type":"integer","value":"1"}.
+	bool insert_tagged(std::string_view type, std::string_view value)
+	{
+		if (type == "string")
+		{
+			builder.insert(std::string(value));
+		}
+		else if (type == "integer")
+		{
+			int64_t integer;
+			if (!parse_integer(value, &integer))
+				return false;
+			builder.insert(integer);
+		}
+		else if (type == "float")
+		{
+			double number;
+			if (!parse_float(value, &number))
+				return false;
+			builder.insert(number);
+		}
+		else if (type == "bool")
+		{
+			if (value != "true" && value != "false")
+				return false;
+			builder.insert(value == "true");
+		}
+		else if (type == "datetime" || type == "datetime-local")
+		{
+			toml::date_time date_time;
+			if (!parse_date_time(value, &date_time, type == "datetime"))
+				return false;
+			builder.insert(date_time);
+		}
+		else if (type == "date-local")
+		{
+			toml::date date;
+			if (!parse_date(value, &date))
+				return false;
+			builder.insert(date);
+		}
+		else if (type == "time-local")
+		{
+			toml::time time;
+			if (!parse_time(value, &time))
+				return false;
+			builder.insert(time);
+		}
+		else
+		{
+			return false;
+		}
+		return true;
+	}
+
+	// Reads an object as a tagged value if it has exactly a string "type" and a string "value".
+	// Otherwise, rewinds to the start of the object and returns false with `*invalid` unset.
+	bool read_tagged(bool* invalid)
+	{
+		const char* object = p;
+		std::string keys[2], values[2];
+		bool matches = consume('{');
+		for (int i = 0; matches && i < 2; i++)
+		{
+			matches = (i == 0 || consume(',')) && read_string(keys[i]) && consume(':');
+			skip_whitespace();
+			matches = matches && p < end && *p == '"' && read_string(values[i]);
+		}
+		matches = matches && consume('}') && keys[0] != keys[1]
+			   && (keys[0] == "type" || keys[0] == "value") && (keys[1] == "type" || keys[1] == "value");
+		if (!matches)
+		{
+			p = object;
+			return false;
+		}
+		const bool type_first = keys[0] == "type";
+		if (!insert_tagged(values[type_first ? 0 : 1], values[type_first ? 1 : 0]))
+		{
+			p		 = object;
+			*invalid = true;
+			return false;
+		}
+		return true;
+	}
+
+	// Reads an object's members into the innermost open table.
+	bool read_members()
+	{
+		if (!consume('{'))
+		{
+			return false;
+		}
+		if (consume('}'))
+		{
+			return true;
+		}
+		do
+		{
+			skip_whitespace();
+			if (!read_string(builder.key) || !consume(':'))
+			{
+				return false;
+			}
+			builder.has_key = true;
+			if (!read_value())
+			{
+				return false;
+			}
+			builder.has_key = false;
+		} while (consume(','));
+		return consume('}');
+	}
+
+	bool read_elements()
+	{
+		if (!consume('['))
+		{
+			return false;
+		}
+		if (consume(']'))
+		{
+			return true;
+		}
+		do
+		{
+			if (!read_value())
+			{
+				return false;
+			}
+		} while (consume(','));
+		return consume(']');
+	}
+
+	bool read_value()
+	{
+		skip_whitespace();
+		if (p == end)
+		{
+			return false;
+		}
+		switch (*p)
+		{
+			case '{':
+			{
+				bool invalid = false;
+				if (tagged && read_tagged(&invalid))
+				{
+					return true;
+				}
+				if (invalid || ++depth > max_depth)
+				{
+					return false;
+				}
+				auto* table = builder.insert(toml::table{});
+				if (!table)
+				{
+					return false;
+				}
+				builder.stack.push_back(table);
+				const bool read = read_members();
+				builder.stack.pop_back();
+				depth--;
+				return read;
+			}
+
+			case '[':
+			{
+				if (++depth > max_depth)
+				{
+					return false;
+				}
+				auto* array = builder.insert(toml::array{});
+				if (!array)
+				{
+					return false;
+				}
+				builder.stack.push_back(array);
+				const bool read = read_elements();
+				builder.stack.pop_back();
+				depth--;
+				return read;
+			}
+
+			case '"':
+			{
+				std::string value;
+				if (!read_string(value))
+				{
+					return false;
+				}
+				builder.insert(std::move(value));
+				return true;
+			}
+
+			case 't':
+				return consume_literal("true") && builder.insert(true);
+
+			case 'f':
+				return consume_literal("false") && builder.insert(false);
+
+			case 'n':
+				// A null member is left out, but an array has no way to skip an element.
+				return !builder.stack.back()->is_array() && consume_literal("null");
+
+			default:
+				return read_number();
+		}
+	}
+
+	// Reads a whole document, which must be an object, into the innermost open table.
+	bool read_document()
+	{
+		if (builder.failed || builder.stack.empty() || !builder.stack.back()->is_table())
+		{
+			return false;
+		}
+		if (!read_members())
+		{
+			return false;
+		}
+		skip_whitespace();
+		return p == end && !builder.failed;
+	}
+};
+
+extern "C"
+{
+	CTomlParseResult ctoml_parse(const char* input, size_t length)
+	{
+		return parse(input, length, nullptr, 0, nullptr, false);
+	}
+
+	CTomlParseResult ctoml_parse_selected(const char* input,
+										  size_t length,
+										  const CTomlString* root_keys,
+										  size_t root_key_count,
+										  const CTomlLimits* limits)
+	{
+		return parse(input, length, root_keys, root_key_count, limits, true);
+	}
+
+	void ctoml_free_result(CTomlParseResult* result)
+	{
+		if (!result)
+		{
+			return;
+		}
+
+		if (result->handle)
+		{
+			delete result->handle;
+			result->handle = nullptr;
 		}
 
 		// Invalidate all other fields to avoid dangling pointers after free.
@@ -285,4 +1731,429 @@ extern "C"
 		result->root.type = CTOML_NONE;
 	}
 
+	ptrdiff_t ctoml_table_find(const CTomlTableData* table, const char* key, size_t length)
+	{
+		if (!table || !table->keys)
+		{
+			return -1;
+		}
+
+		// convert_table walks the toml::table's underlying std::map in order,
+		// and toml::key compares with the same char_traits as std::string_view.
+		std::string_view needle(key, length);
+		size_t low	= 0;
+		size_t high = table->count;
+		while (low < high)
+		{
+			size_t mid = low + (high - low) / 2;
+			std::string_view candidate(table->keys[mid].data, table->keys[mid].length);
+			int order = candidate.compare(needle);
+			if (order == 0)
+			{
+				return static_cast<ptrdiff_t>(mid);
+			}
+			if (order < 0)
+			{
+				low = mid + 1;
+			}
+			else
+			{
+				high = mid;
+			}
+		}
+		return -1;
+	}
+
+	CTomlBuilder* ctoml_builder_create(void)
+	{
+		try
+		{
+			return new CTomlBuilder();
+		}
+		catch (...)
+		{
+			return nullptr;
+		}
+	}
+
+	void ctoml_builder_free(CTomlBuilder* builder)
+	{
+		delete builder;
+	}
+
+	bool ctoml_builder_read_json(
+		CTomlBuilder* builder, const char* input, size_t length, bool tagged, size_t* error_offset)
+	{
+		if (!builder)
+		{
+			return false;
+		}
+		json_reader reader(*builder, input, length, tagged);
+		bool read;
+		try
+		{
+			read = reader.read_document();
+		}
+		catch (...)
+		{
+			read = false;
+		}
+		if (!read)
+		{
+			builder->failed = true;
+			if (error_offset)
+			{
+				*error_offset = static_cast<size_t>(reader.p - reader.start);
+			}
+		}
+		return read;
+	}
+
+	void ctoml_builder_key(CTomlBuilder* builder, const char* key, size_t length)
+	{
+		if (!builder)
+		{
+			return;
+		}
+		try
+		{
+			builder->key.assign(key, length);
+			builder->has_key = true;
+		}
+		catch (...)
+		{
+			builder->failed = true;
+		}
+	}
+
+	void ctoml_builder_string(CTomlBuilder* builder, const char* value, size_t length)
+	{
+		if (!builder)
+		{
+			return;
+		}
+		try
+		{
+			builder->insert(std::string(value, length));
+		}
+		catch (...)
+		{
+			builder->failed = true;
+		}
+	}
+
+	void ctoml_builder_integer(CTomlBuilder* builder, int64_t value)
+	{
+		if (!builder)
+		{
+			return;
+		}
+		try
+		{
+			builder->insert(value);
+		}
+		catch (...)
+		{
+			builder->failed = true;
+		}
+	}
+
+	void ctoml_builder_float(CTomlBuilder* builder, double value)
+	{
+		if (!builder)
+		{
+			return;
+		}
+		try
+		{
+			builder->insert(value);
+		}
+		catch (...)
+		{
+			builder->failed = true;
+		}
+	}
+
+	void ctoml_builder_boolean(CTomlBuilder* builder, bool value)
+	{
+		if (!builder)
+		{
+			return;
+		}
+		try
+		{
+			builder->insert(value);
+		}
+		catch (...)
+		{
+			builder->failed = true;
+		}
+	}
+
+	void ctoml_builder_date(CTomlBuilder* builder, CTomlDate value)
+	{
+		if (!builder)
+		{
+			return;
+		}
+		toml::date date;
+		if (!make_date(value, &date))
+		{
+			builder->failed = true;
+			return;
+		}
+		try
+		{
+			builder->insert(date);
+		}
+		catch (...)
+		{
+			builder->failed = true;
+		}
+	}
+
+	void ctoml_builder_time(CTomlBuilder* builder, CTomlTime value)
+	{
+		if (!builder)
+		{
+			return;
+		}
+		toml::time time;
+		if (!make_time(value, &time))
+		{
+			builder->failed = true;
+			return;
+		}
+		try
+		{
+			builder->insert(time);
+		}
+		catch (...)
+		{
+			builder->failed = true;
+		}
+	}
+
+	void ctoml_builder_date_time(CTomlBuilder* builder, CTomlDateTime value)
+	{
+		if (!builder)
+		{
+			return;
+		}
+		toml::date date;
+		toml::time time;
+		if (!make_date(value.date, &date) || !make_time(value.time, &time))
+		{
+			builder->failed = true;
+			return;
+		}
+		try
+		{
+			if (value.has_offset)
+			{
+				builder->insert(toml::date_time{ date, time, toml::time_offset{ 0, value.offset_minutes } });
+			}
+			else
+			{
+				builder->insert(toml::date_time{ date, time });
+			}
+		}
+		catch (...)
+		{
+			builder->failed = true;
+		}
+	}
+
+	void ctoml_builder_instant(CTomlBuilder* builder, int64_t epoch_seconds, int32_t nanoseconds)
+	{
+		if (!builder)
+		{
+			return;
+		}
+		int64_t days			= epoch_seconds / 86400;
+		int64_t seconds_of_day	= epoch_seconds % 86400;
+		if (seconds_of_day < 0)
+		{
+			seconds_of_day += 86400;
+			days -= 1;
+		}
+		int64_t year, month, day;
+		civil_from_days(days, &year, &month, &day);
+
+		CTomlDateTime value{};
+		value.date.year			= static_cast<int32_t>(year);
+		value.date.month		= static_cast<int32_t>(month);
+		value.date.day			= static_cast<int32_t>(day);
+		value.time.hour			= static_cast<int32_t>(seconds_of_day / 3600);
+		value.time.minute		= static_cast<int32_t>(seconds_of_day / 60 % 60);
+		value.time.second		= static_cast<int32_t>(seconds_of_day % 60);
+		value.time.nanosecond	= nanoseconds;
+		value.has_offset		= true;
+		value.offset_minutes	= 0;
+		if (year < 0 || year > 9999)
+		{
+			builder->failed = true;
+			return;
+		}
+		ctoml_builder_date_time(builder, value);
+	}
+
+	void ctoml_builder_begin_table(CTomlBuilder* builder)
+	{
+		if (!builder)
+		{
+			return;
+		}
+		try
+		{
+			if (auto* node = builder->insert(toml::table{}))
+			{
+				builder->stack.push_back(node);
+			}
+		}
+		catch (...)
+		{
+			builder->failed = true;
+		}
+	}
+
+	void ctoml_builder_begin_array(CTomlBuilder* builder)
+	{
+		if (!builder)
+		{
+			return;
+		}
+		try
+		{
+			if (auto* node = builder->insert(toml::array{}))
+			{
+				builder->stack.push_back(node);
+			}
+		}
+		catch (...)
+		{
+			builder->failed = true;
+		}
+	}
+
+	void ctoml_builder_end(CTomlBuilder* builder)
+	{
+		if (!builder)
+		{
+			return;
+		}
+		if (builder->stack.size() <= 1)
+		{
+			builder->failed = true;
+			return;
+		}
+		builder->stack.pop_back();
+	}
+
+	bool ctoml_builder_write(const CTomlBuilder* builder, CTomlBuffer* buffer)
+	{
+		if (!builder || builder->failed || builder->stack.size() != 1)
+		{
+			return false;
+		}
+		try
+		{
+			buffer_streambuf streambuf(buffer);
+			std::ostream stream(&streambuf);
+			stream.exceptions(std::ios::badbit);
+			stream << toml::toml_formatter{ builder->root, toml::format_flags::allow_unicode_strings };
+			return true;
+		}
+		catch (...)
+		{
+			return false;
+		}
+	}
+
+	bool ctoml_to_tagged_json(const CTomlParseResult* result, CTomlBuffer* buffer)
+	{
+		if (!result || !result->success || !buffer)
+		{
+			return false;
+		}
+		tagged_json_writer writer{ buffer };
+		writer.write_node(result->root);
+		return writer.ok;
+	}
+
+	CTomlFormatFlags ctoml_format_default_flags(CTomlFormat format)
+	{
+		switch (format)
+		{
+			case CTOML_FORMAT_JSON:
+				return static_cast<CTomlFormatFlags>(toml::json_formatter::default_flags);
+			case CTOML_FORMAT_YAML:
+				return static_cast<CTomlFormatFlags>(toml::yaml_formatter::default_flags);
+			default:
+				return static_cast<CTomlFormatFlags>(toml::toml_formatter::default_flags);
+		}
+	}
+
+	bool ctoml_format(const CTomlParseResult* result,
+					  CTomlFormat format,
+					  CTomlFormatFlags flags,
+					  CTomlWriteCallback write,
+					  void* context)
+	{
+		if (!result || !result->success || !write)
+		{
+			return false;
+		}
+		try
+		{
+			CTomlBuilder builder;
+			const CTomlTableData& root = result->root.data.table_value;
+			for (size_t i = 0; i < root.count; i++)
+			{
+				builder.key.assign(root.keys[i].data, root.keys[i].length);
+				builder.has_key = true;
+				rebuild_node(builder, root.values[i]);
+			}
+			if (builder.failed)
+			{
+				return false;
+			}
+
+			callback_streambuf streambuf(write, context);
+			std::ostream stream(&streambuf);
+			stream.exceptions(std::ios::badbit);
+			const auto format_flags = static_cast<toml::format_flags>(flags);
+			switch (format)
+			{
+				case CTOML_FORMAT_JSON:
+					stream << toml::json_formatter{ builder.root, format_flags };
+					break;
+				case CTOML_FORMAT_YAML:
+					stream << toml::yaml_formatter{ builder.root, format_flags };
+					break;
+				default:
+					stream << toml::toml_formatter{ builder.root, format_flags };
+					break;
+			}
+			stream.flush();
+			return true;
+		}
+		catch (...)
+		{
+			return false;
+		}
+	}
+
+	void ctoml_buffer_free(CTomlBuffer* buffer)
+	{
+		if (!buffer)
+		{
+			return;
+		}
+		std::free(buffer->data);
+		buffer->data	 = nullptr;
+		buffer->length	 = 0;
+		buffer->capacity = 0;
+	}
+
 } // extern "C"
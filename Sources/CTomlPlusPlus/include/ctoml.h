@@ -56,6 +56,9 @@ _Static_assert(sizeof(CTomlNodeType) == 4, "CTomlNodeType must be 4 bytes for Sw
 		CTomlTime time;
 		bool has_offset;
 		int32_t offset_minutes;
+		// Seconds and nanoseconds since 1970-01-01T00:00:00Z (only valid if has_offset == true)
+		int64_t epoch_seconds;
+		int32_t epoch_nanoseconds;
 	} CTomlDateTime;
 
 	// String with explicit length (handles embedded null characters)
@@ -76,11 +79,15 @@ _Static_assert(sizeof(CTomlNodeType) == 4, "CTomlNodeType must be 4 bytes for Sw
 	} CTomlArrayData;
 
 	// Table data structure
+	// Entries are sorted by key bytes, for binary search with ctoml_table_find.
 	typedef struct
 	{
 		CTomlString* keys;
 		struct CTomlNode* values;
 		size_t count;
+		// Indices of the entries in the order their keys appear in the document,
+		// or null if that's the same as key order.
+		size_t* order;
 	} CTomlTableData;
 
 	// Node value union - holds the actual data
@@ -114,10 +121,136 @@ _Static_assert(sizeof(CTomlNodeType) == 4, "CTomlNodeType must be 4 bytes for Sw
 		CTomlTable* handle;
 	} CTomlParseResult;
 
+	// Limits on the shape of a document, matching TOMLDecoder.DecodingLimits
+	typedef struct
+	{
+		int64_t max_depth;
+		int64_t max_table_keys;
+		int64_t max_array_length;
+		int64_t max_string_length;
+	} CTomlLimits;
+
 	// Parsing
 	CTomlParseResult ctoml_parse(const char* input, size_t length);
+	// Parses the whole document, like ctoml_parse, but only converts the root table's
+	// entries whose keys are listed in `root_keys`; all other root entries are left out.
+	// The root table and the entries left out are checked against `limits`,
+	// and parsing fails if they break one. An entry holding a string that may be
+	// too long is converted anyway, since string length is counted in characters.
+	CTomlParseResult ctoml_parse_selected(const char* input,
+										  size_t length,
+										  const CTomlString* root_keys,
+										  size_t root_key_count,
+										  const CTomlLimits* limits);
 	void ctoml_free_result(CTomlParseResult* result);
 
+	// Table lookup
+	// Returns the index of `key` in `table`, or -1 if the table has no such key.
+	// Keys are stored in the byte-wise order toml++ keeps them in,
+	// so lookups are a binary search rather than a linear scan.
+	ptrdiff_t ctoml_table_find(const CTomlTableData* table, const char* key, size_t length);
+
+	// Growable byte buffer for serialized output.
+	// `data` is allocated with malloc and grown with realloc;
+	// release it with ctoml_buffer_free.
+	typedef struct
+	{
+		char* data;
+		size_t length;
+		size_t capacity;
+	} CTomlBuffer;
+
+	// Opaque document builder
+	typedef struct CTomlBuilder CTomlBuilder;
+
+	// Document building
+	// Values are added to the innermost open table or array, starting with the root table.
+	// Inside a table, each value or nested container must be preceded by ctoml_builder_key.
+	// Errors, such as invalid dates or running out of memory, are reported by ctoml_builder_write.
+	// Every function accepts a null builder: adding to it does nothing, and reading or writing it fails.
+	CTomlBuilder* ctoml_builder_create(void);
+	void ctoml_builder_free(CTomlBuilder* builder);
+	void ctoml_builder_key(CTomlBuilder* builder, const char* key, size_t length);
+	void ctoml_builder_string(CTomlBuilder* builder, const char* value, size_t length);
+	void ctoml_builder_integer(CTomlBuilder* builder, int64_t value);
+	void ctoml_builder_float(CTomlBuilder* builder, double value);
+	void ctoml_builder_boolean(CTomlBuilder* builder, bool value);
+	void ctoml_builder_date(CTomlBuilder* builder, CTomlDate value);
+	void ctoml_builder_time(CTomlBuilder* builder, CTomlTime value);
+	void ctoml_builder_date_time(CTomlBuilder* builder, CTomlDateTime value);
+	// Adds an offset date-time in UTC, from seconds and nanoseconds since 1970-01-01T00:00:00Z.
+	void ctoml_builder_instant(CTomlBuilder* builder, int64_t epoch_seconds, int32_t nanoseconds);
+	void ctoml_builder_begin_table(CTomlBuilder* builder);
+	void ctoml_builder_begin_array(CTomlBuilder* builder);
+	// Closes the innermost open table or array.
+	void ctoml_builder_end(CTomlBuilder* builder);
+	// Reads a JSON object's members into the innermost open table, without building a JSON tree.
+	// Objects become tables and arrays become arrays. Null members are left out,
+	// and null array elements make reading fail.
+	// Integers that fit in 64 bits stay integers; other numbers become floats.
+	// With `tagged`, objects with only string "type" and "value" members are read as
+	// toml-test's tagged values, such as {"type":"date-local","value":"2024-01-15"}.
+	// Returns false if the JSON is invalid or a tagged value can't be read,
+	// setting `error_offset`, if it isn't null, to the byte offset where reading stopped.
+	bool ctoml_builder_read_json(
+		CTomlBuilder* builder, const char* input, size_t length, bool tagged, size_t* error_offset);
+
+	// Serialization
+	// Appends the built document to `buffer` using toml++'s TOML formatter.
+	// Returns false if building failed, a container is still open, or memory ran out.
+	bool ctoml_builder_write(const CTomlBuilder* builder, CTomlBuffer* buffer);
+	// Appends a successfully parsed document to `buffer` as toml-test's tagged JSON,
+	// where each value is an object holding its TOML type and its value as a string.
+	// Offset date-times are written in UTC. Returns false if the result isn't a parsed
+	// document or memory ran out.
+	bool ctoml_to_tagged_json(const CTomlParseResult* result, CTomlBuffer* buffer);
+	void ctoml_buffer_free(CTomlBuffer* buffer);
+
+	// Output formats for ctoml_format
+	typedef enum
+	{
+		CTOML_FORMAT_TOML = 0,
+		CTOML_FORMAT_JSON,
+		CTOML_FORMAT_YAML
+	} CTomlFormat;
+
+	// Formatting flags, matching toml++'s format_flags.
+	// Some formats always set or ignore certain flags; JSON and YAML always quote dates and times.
+	typedef uint64_t CTomlFormatFlags;
+	enum
+	{
+		CTOML_FORMAT_QUOTE_DATES_AND_TIMES		= 1 << 0,
+		CTOML_FORMAT_QUOTE_INFINITIES_AND_NANS	= 1 << 1,
+		CTOML_FORMAT_ALLOW_LITERAL_STRINGS		= 1 << 2,
+		CTOML_FORMAT_ALLOW_MULTI_LINE_STRINGS	= 1 << 3,
+		CTOML_FORMAT_ALLOW_REAL_TABS_IN_STRINGS = 1 << 4,
+		CTOML_FORMAT_ALLOW_UNICODE_STRINGS		= 1 << 5,
+		CTOML_FORMAT_ALLOW_BINARY_INTEGERS		= 1 << 6,
+		CTOML_FORMAT_ALLOW_OCTAL_INTEGERS		= 1 << 7,
+		CTOML_FORMAT_ALLOW_HEXADECIMAL_INTEGERS = 1 << 8,
+		CTOML_FORMAT_INDENT_SUB_TABLES			= 1 << 9,
+		CTOML_FORMAT_INDENT_ARRAY_ELEMENTS		= 1 << 10,
+		CTOML_FORMAT_RELAXED_FLOAT_PRECISION	= 1 << 11,
+		CTOML_FORMAT_TERSE_KEY_VALUE_PAIRS		= 1 << 12,
+		CTOML_FORMAT_FORCE_MULTILINE_ARRAYS		= 1 << 13
+	};
+
+	// Receives formatted output in chunks. Returning false stops formatting.
+	typedef bool (*CTomlWriteCallback)(void* context, const char* data, size_t length);
+
+	// Formatting
+	// The flags each formatter uses by default, to start from when changing individual flags.
+	CTomlFormatFlags ctoml_format_default_flags(CTomlFormat format);
+	// Writes a successfully parsed document as TOML, JSON, or YAML with toml++'s formatters,
+	// passing the output to `write` with `context` as it's produced.
+	// Returns false if the result isn't a parsed document, `write` returned false,
+	// or memory ran out.
+	bool ctoml_format(const CTomlParseResult* result,
+					  CTomlFormat format,
+					  CTomlFormatFlags flags,
+					  CTomlWriteCallback write,
+					  void* context);
+
 #ifdef __cplusplus
 }
 #endif
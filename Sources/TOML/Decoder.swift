@@ -78,6 +78,30 @@ public final class TOMLDecoder {
         case convertFromSnakeCase
     }
 
+    // MARK: - Array Decoding Strategy
+
+    /// The strategy used when decoding arrays.
+    ///
+    /// Elements of a TOML array are independent of one another,
+    /// so large arrays, such as long arrays of tables,
+    /// can be split into chunks and decoded on several threads at once.
+    /// Elements are always returned in document order.
+    public enum ArrayDecodingStrategy: Sendable {
+        /// Decode elements one at a time, on the calling thread.
+        ///
+        /// This is the default strategy.
+        case serial
+
+        /// Decode arrays with at least `minimumCount` elements in parallel chunks.
+        ///
+        /// Smaller arrays, and arrays nested inside an array being decoded in parallel,
+        /// are decoded serially.
+        ///
+        /// - Important: The elements' `init(from:)` implementations
+        ///   are called concurrently, so they must not share mutable state.
+        case concurrent(minimumCount: Int = 1024)
+    }
+
     // MARK: - Decoding Limits
 
     /// Limits for decoding to prevent resource exhaustion.
@@ -160,9 +184,27 @@ public final class TOMLDecoder {
     /// The strategy used when decoding keys.
     public var keyDecodingStrategy: KeyDecodingStrategy = .useDefaultKeys
 
+    /// The strategy used when decoding arrays.
+    public var arrayDecodingStrategy: ArrayDecodingStrategy = .serial
+
     /// The limits applied during decoding.
     public var limits: DecodingLimits = .default
 
+    /// Whether to skip converting root tables and values that the decoded type never reads.
+    ///
+    /// When `true`, the decoder remembers which root keys each type reads.
+    /// After a type has been decoded once,
+    /// root entries it hasn't read are left out of later decodes instead of being converted.
+    /// The whole document is still parsed and checked against ``limits``.
+    ///
+    /// - Important: If a type reads a root key it hasn't read before,
+    ///   or needs every root key, as a dictionary does,
+    ///   it's decoded again from the whole document,
+    ///   so its `init(from:)` can run twice for a single call.
+    ///
+    /// The default is `false`.
+    public var skipsUnreadRootKeys = false
+
     /// A dictionary of contextual information to pass to the decoder.
     public var userInfo: [CodingUserInfoKey: any Sendable] = [:]
 
@@ -175,16 +217,31 @@ public final class TOMLDecoder {
 
     /// Decodes a value of the given type from TOML data.
     ///
+    /// The bytes are parsed in place; UTF-8 validation happens once, in the parser.
+    ///
     /// - Parameters:
     ///   - type: The type to decode.
     ///   - data: UTF-8 encoded TOML data.
     /// - Returns: The decoded value.
     /// - Throws: ``TOMLDecodingError`` if parsing or decoding fails.
     public func decode<T: Decodable>(_ type: T.Type, from data: Data) throws -> T {
-        guard let string = String(data: data, encoding: .utf8) else {
-            throw TOMLDecodingError.invalidData("Unable to convert data to UTF-8 string")
+        try data.withUnsafeBytes { (buffer: UnsafeRawBufferPointer) in
+            try decode(type, from: buffer)
+        }
+    }
+
+    /// Decodes a value of the given type from UTF-8 encoded TOML bytes,
+    /// such as a `[UInt8]` array.
+    ///
+    /// - Parameters:
+    ///   - type: The type to decode.
+    ///   - bytes: UTF-8 encoded TOML data.
+    /// - Returns: The decoded value.
+    /// - Throws: ``TOMLDecodingError`` if parsing or decoding fails.
+    public func decode<T: Decodable>(_ type: T.Type, from bytes: some ContiguousBytes) throws -> T {
+        try bytes.withUnsafeBytes { buffer in
+            try decode(type, from: buffer)
         }
-        return try decode(type, from: string)
     }
 
     /// Decodes a value of the given type from a TOML string.
@@ -195,163 +252,255 @@ public final class TOMLDecoder {
     /// - Returns: The decoded value.
     /// - Throws: ``TOMLDecodingError`` if parsing or decoding fails.
     public func decode<T: Decodable>(_ type: T.Type, from string: String) throws -> T {
-        if string.utf8.count > limits.maxInputSize {
-            throw TOMLDecodingError.invalidData("Input exceeds maximum size of \(limits.maxInputSize) bytes")
+        var string = string
+        return try string.withUTF8 { utf8 in
+            try decode(type, from: UnsafeRawBufferPointer(utf8))
         }
-
-        let value = try parseToValue(string)
-        let decoder = _TOMLDecoder(
-            value: value,
-            codingPath: [],
-            userInfo: userInfo.reduce(into: [:]) { $0[$1.key] = $1.value },
-            options: DecodingOptions(
-                dateDecodingStrategy: dateDecodingStrategy,
-                keyDecodingStrategy: keyDecodingStrategy
-            )
-        )
-        return try T(from: decoder)
     }
 
-    // MARK: - Private
+    /// Decodes a value of the given type from a buffer of UTF-8 encoded TOML.
+    ///
+    /// The buffer only needs to stay valid for the duration of the call.
+    ///
+    /// - Parameters:
+    ///   - type: The type to decode.
+    ///   - buffer: UTF-8 encoded TOML data.
+    /// - Returns: The decoded value.
+    /// - Throws: ``TOMLDecodingError`` if parsing or decoding fails.
+    public func decode<T: Decodable>(_ type: T.Type, from buffer: UnsafeRawBufferPointer) throws -> T {
+        try limits.validateInputSize(buffer.count)
+
+        guard skipsUnreadRootKeys else {
+            return try decode(type, from: TOMLParseResult(parsing: buffer), recording: nil)
+        }
 
-    private func parseToValue(_ string: String) throws -> TOMLValue {
-        var result = string.withCString { cString in
-            ctoml_parse(cString, string.utf8.count)
+        let plan = RootKeyPlanCache.shared.plan(for: type, keyDecodingStrategy: keyDecodingStrategy)
+        if let selectedKeys = plan.selectedKeys {
+            let recorder = RootKeyRecorder(selectedKeys: selectedKeys)
+            let result = Result {
+                try decode(
+                    type,
+                    from: TOMLParseResult(parsing: buffer, rootKeys: selectedKeys, limits: limits),
+                    recording: recorder
+                )
+            }
+            if !recorder.missed {
+                return try result.get()
+            }
+            // The type asked for a root key that wasn't converted,
+            // so decode again from the whole document.
         }
-        defer { ctoml_free_result(&result) }
 
-        guard result.success else {
-            if let errorMsg = result.error_message {
-                let message = String(cString: errorMsg)
-                let line = Int(result.error_line)
-                let column = Int(result.error_column)
-                if line > 0 || column > 0 {
-                    throw TOMLDecodingError.invalidSyntax(line: line, column: column, message: message)
+        let recorder = RootKeyRecorder(selectedKeys: nil)
+        let value = try decode(type, from: TOMLParseResult(parsing: buffer), recording: recorder)
+        plan.update(with: recorder)
+        return value
+    }
+
+    /// Decodes a value of the given type from an asynchronous sequence of UTF-8 encoded bytes,
+    /// such as the `bytes` of a `URLSession` response.
+    ///
+    /// Bytes are collected into a single buffer as they arrive
+    /// and parsed once the sequence finishes.
+    /// Input longer than `limits.maxInputSize` is rejected
+    /// as soon as that many bytes have been received.
+    ///
+    /// - Parameters:
+    ///   - type: The type to decode.
+    ///   - bytes: An asynchronous sequence of UTF-8 encoded TOML data.
+    /// - Returns: The decoded value.
+    /// - Throws: ``TOMLDecodingError`` if parsing or decoding fails,
+    ///   or any error thrown by the sequence.
+    public func decode<T: Decodable, S: AsyncSequence>(
+        _ type: T.Type,
+        from bytes: S
+    ) async throws -> T where S.Element == UInt8 {
+        var buffer: [UInt8] = []
+        for try await byte in bytes {
+            guard buffer.count < limits.maxInputSize else {
+                throw TOMLDecodingError.invalidData("Input exceeds maximum size of \(limits.maxInputSize) bytes")
+            }
+            buffer.append(byte)
+        }
+        return try decode(type, from: buffer)
+    }
+
+    /// Decodes a value of the given type from an asynchronous sequence of chunks
+    /// of UTF-8 encoded bytes, such as `Data` or `[UInt8]` values.
+    ///
+    /// Chunks are appended to a single buffer as they arrive
+    /// and parsed once the sequence finishes.
+    /// Input longer than `limits.maxInputSize` is rejected
+    /// as soon as the chunk that exceeds it is received.
+    ///
+    /// - Parameters:
+    ///   - type: The type to decode.
+    ///   - chunks: An asynchronous sequence of UTF-8 encoded TOML data.
+    /// - Returns: The decoded value.
+    /// - Throws: ``TOMLDecodingError`` if parsing or decoding fails,
+    ///   or any error thrown by the sequence.
+    public func decode<T: Decodable, S: AsyncSequence>(
+        _ type: T.Type,
+        from chunks: S
+    ) async throws -> T where S.Element: ContiguousBytes {
+        var buffer: [UInt8] = []
+        for try await chunk in chunks {
+            try chunk.withUnsafeBytes { bytes in
+                guard bytes.count <= limits.maxInputSize - buffer.count else {
+                    throw TOMLDecodingError.invalidData("Input exceeds maximum size of \(limits.maxInputSize) bytes")
                 }
-                throw TOMLDecodingError.invalidData(message)
+                buffer.append(contentsOf: bytes)
             }
-            throw TOMLDecodingError.invalidData("Unknown parse error")
         }
+        return try decode(type, from: buffer)
+    }
+
+    // MARK: - Decoding Values
 
-        return try convertNode(result.root, depth: 0)
+    /// Decodes TOML data as a ``TOMLValue``, without a `Decodable` type.
+    ///
+    /// - Parameter data: UTF-8 encoded TOML data.
+    /// - Returns: The document's root table.
+    /// - Throws: ``TOMLDecodingError`` if parsing fails or the document exceeds ``limits``.
+    public func decodeValue(from data: Data) throws -> TOMLValue {
+        try data.withUnsafeBytes { (buffer: UnsafeRawBufferPointer) in
+            try decodeValue(from: buffer)
+        }
     }
 
-    private func decodeCTomlString(_ strData: CTomlString) -> String {
-        if let data = strData.data {
-            let buffer = UnsafeRawBufferPointer(start: data, count: strData.length)
-            return String(decoding: buffer, as: UTF8.self)
+    /// Decodes a TOML string as a ``TOMLValue``, without a `Decodable` type.
+    ///
+    /// - Parameter string: A string containing TOML content.
+    /// - Returns: The document's root table.
+    /// - Throws: ``TOMLDecodingError`` if parsing fails or the document exceeds ``limits``.
+    public func decodeValue(from string: String) throws -> TOMLValue {
+        var string = string
+        return try string.withUTF8 { utf8 in
+            try decodeValue(from: UnsafeRawBufferPointer(utf8))
         }
-        return ""
     }
 
-    private func convertNode(_ node: CTomlNode, depth: Int) throws -> TOMLValue {
-        guard depth < limits.maxDepth else {
-            throw TOMLDecodingError.invalidData("Maximum nesting depth of \(limits.maxDepth) exceeded")
+    /// Decodes a buffer of UTF-8 encoded TOML as a ``TOMLValue``, without a `Decodable` type.
+    ///
+    /// Every value is converted straight from the parser's output, with its TOML type,
+    /// so this is the fastest way to read a document whose shape isn't known in advance.
+    /// Date and key decoding strategies don't apply.
+    ///
+    /// - Parameter buffer: UTF-8 encoded TOML data.
+    /// - Returns: The document's root table.
+    /// - Throws: ``TOMLDecodingError`` if parsing fails or the document exceeds ``limits``.
+    public func decodeValue(from buffer: UnsafeRawBufferPointer) throws -> TOMLValue {
+        try limits.validateInputSize(buffer.count)
+
+        let document = try TOMLParseResult(parsing: buffer)
+        try limits.validate(document.root)
+        return TOMLValue(document.root)
+    }
+
+    // MARK: - Tagged JSON
+
+    /// Converts TOML data to the tagged JSON used by the
+    /// [toml-test](https://github.com/toml-lang/toml-test) suite.
+    ///
+    /// Every value is written as an object with its TOML type and its value as a string,
+    /// such as `{"type":"integer","value":"8080"}`, while tables and arrays are written as
+    /// JSON objects and arrays, with keys in sorted order.
+    /// Offset date-times are written in UTC, with millisecond precision.
+    /// The JSON is written straight from the parser's output,
+    /// without converting the document to Swift values.
+    ///
+    /// - Parameter data: UTF-8 encoded TOML data.
+    /// - Returns: UTF-8 encoded JSON, without a trailing newline.
+    /// - Throws: ``TOMLDecodingError`` if parsing fails or the document exceeds ``limits``.
+    public func taggedJSON(from data: Data) throws -> Data {
+        try limits.validateInputSize(data.count)
+
+        let document = try data.withUnsafeBytes { try TOMLParseResult(parsing: $0) }
+        try limits.validate(document.root)
+        return try document.taggedJSON()
+    }
+
+    // MARK: - Private
+
+    private func decode<T: Decodable>(
+        _ type: T.Type,
+        from document: TOMLParseResult,
+        recording recorder: RootKeyRecorder?
+    ) throws -> T {
+        try limits.validate(document.root)
+
+        let decoder = _TOMLDecoder(
+            node: document.root,
+            document: document,
+            path: .root,
+            userInfo: userInfo.reduce(into: [:]) { $0[$1.key] = $1.value },
+            options: DecodingOptions(
+                dateDecodingStrategy: dateDecodingStrategy,
+                keyDecodingStrategy: keyDecodingStrategy,
+                arrayDecodingStrategy: arrayDecodingStrategy
+            ),
+            plans: DecodingPlans(keyDecodingStrategy: keyDecodingStrategy),
+            rootKeys: recorder
+        )
+        return try decoder.decode(type)
+    }
+}
+
+// MARK: - Validating Limits
+
+extension TOMLDecoder.DecodingLimits {
+    /// Checks the size of the input before it's parsed.
+    ///
+    /// - Throws: ``TOMLDecodingError/invalidData(_:)`` if the input exceeds ``maxInputSize``.
+    func validateInputSize(_ byteCount: Int) throws {
+        if byteCount > maxInputSize {
+            throw TOMLDecodingError.invalidData("Input exceeds maximum size of \(maxInputSize) bytes")
+        }
+    }
+
+    /// Checks a parsed tree against these limits before any of it is converted.
+    ///
+    /// - Throws: ``TOMLDecodingError/invalidData(_:)`` for the first limit the tree exceeds.
+    func validate(_ node: CTomlNode, depth: Int = 0) throws {
+        guard depth < maxDepth else {
+            throw TOMLDecodingError.invalidData("Maximum nesting depth of \(maxDepth) exceeded")
         }
 
         switch node.type {
         case CTOML_STRING:
-            let str = decodeCTomlString(node.data.string_value)
-            guard str.count <= limits.maxStringLength else {
+            // A string never has more characters than UTF-8 code units,
+            // so only strings with too many bytes need to be counted.
+            let string = node.data.string_value
+            guard string.length <= maxStringLength || String(string).count <= maxStringLength else {
                 throw TOMLDecodingError.invalidData(
-                    "String exceeds maximum length of \(limits.maxStringLength) characters"
-                )
-            }
-            return .string(str)
-
-        case CTOML_INTEGER:
-            return .integer(node.data.integer_value)
-
-        case CTOML_FLOAT:
-            return .float(node.data.float_value)
-
-        case CTOML_BOOLEAN:
-            return .boolean(node.data.boolean_value)
-
-        case CTOML_DATE:
-            let d = node.data.date_value
-            return .localDate(
-                LocalDate(
-                    year: Int(d.year),
-                    month: Int(d.month),
-                    day: Int(d.day)
+                    "String exceeds maximum length of \(maxStringLength) characters"
                 )
-            )
-
-        case CTOML_TIME:
-            let t = node.data.time_value
-            return .localTime(
-                LocalTime(
-                    hour: Int(t.hour),
-                    minute: Int(t.minute),
-                    second: Int(t.second),
-                    nanosecond: Int(t.nanosecond)
-                )
-            )
-
-        case CTOML_DATETIME:
-            let dt = node.data.datetime_value
-            if dt.has_offset {
-                var components = DateComponents()
-                components.year = Int(dt.date.year)
-                components.month = Int(dt.date.month)
-                components.day = Int(dt.date.day)
-                components.hour = Int(dt.time.hour)
-                components.minute = Int(dt.time.minute)
-                components.second = Int(dt.time.second)
-                components.nanosecond = Int(dt.time.nanosecond)
-                components.timeZone = TimeZone(secondsFromGMT: Int(dt.offset_minutes) * 60)
-
-                if let date = Calendar(identifier: .gregorian).date(from: components) {
-                    return .offsetDateTime(date)
-                }
             }
-            return .localDateTime(
-                LocalDateTime(
-                    year: Int(dt.date.year),
-                    month: Int(dt.date.month),
-                    day: Int(dt.date.day),
-                    hour: Int(dt.time.hour),
-                    minute: Int(dt.time.minute),
-                    second: Int(dt.time.second),
-                    nanosecond: Int(dt.time.nanosecond)
-                )
-            )
 
         case CTOML_ARRAY:
-            let count = node.data.array_value.count
-            guard count <= limits.maxArrayLength else {
-                throw TOMLDecodingError.invalidData("Array exceeds maximum length of \(limits.maxArrayLength) elements")
+            let array = node.data.array_value
+            guard array.count <= maxArrayLength else {
+                throw TOMLDecodingError.invalidData("Array exceeds maximum length of \(maxArrayLength) elements")
             }
-            var values: [TOMLValue] = []
-            if let elements = node.data.array_value.elements {
-                for i in 0 ..< count {
-                    try values.append(convertNode(elements[i], depth: depth + 1))
+            if let elements = array.elements {
+                for i in 0 ..< array.count {
+                    try validate(elements[i], depth: depth + 1)
                 }
             }
-            return .array(values)
 
         case CTOML_TABLE:
-            let count = node.data.table_value.count
-            guard count <= limits.maxTableKeys else {
-                throw TOMLDecodingError.invalidData("Table exceeds maximum of \(limits.maxTableKeys) keys")
+            let table = node.data.table_value
+            guard table.count <= maxTableKeys else {
+                throw TOMLDecodingError.invalidData("Table exceeds maximum of \(maxTableKeys) keys")
             }
-            var dict: [String: TOMLValue] = [:]
-            if let keys = node.data.table_value.keys, let tableValues = node.data.table_value.values {
-                for i in 0 ..< count {
-                    let key = decodeCTomlString(keys[i])
-                    dict[key] = try convertNode(tableValues[i], depth: depth + 1)
+            if let values = table.values {
+                for i in 0 ..< table.count {
+                    try validate(values[i], depth: depth + 1)
                 }
             }
-            return .table(dict)
 
-        case CTOML_NONE:
-            return .string("")
-
-        // We can't use `@unknown default` here because
-        // the C enum imports as a plain enum and exhaustiveness isn't tracked.
         default:
-            return .string("")
+            break
         }
     }
 }
@@ -404,126 +553,418 @@ public enum TOMLDecodingError: Error, CustomStringConvertible, Sendable {
 struct DecodingOptions {
     let dateDecodingStrategy: TOMLDecoder.DateDecodingStrategy
     let keyDecodingStrategy: TOMLDecoder.KeyDecodingStrategy
+    let arrayDecodingStrategy: TOMLDecoder.ArrayDecodingStrategy
+
+    /// The options of a newly created ``TOMLDecoder``.
+    static let `default` = DecodingOptions(
+        dateDecodingStrategy: .iso8601,
+        keyDecodingStrategy: .useDefaultKeys,
+        arrayDecodingStrategy: .serial
+    )
+
+    /// These options with arrays decoded serially.
+    var serial: DecodingOptions {
+        DecodingOptions(
+            dateDecodingStrategy: dateDecodingStrategy,
+            keyDecodingStrategy: keyDecodingStrategy,
+            arrayDecodingStrategy: .serial
+        )
+    }
 }
 
 // MARK: - Internal Decoder
 
+/// Decodes values directly from the C tree of a parse result.
+///
+/// Containers read `CTomlNode` values in place,
+/// so scalars are converted exactly once, straight into the requested type.
 final class _TOMLDecoder: Decoder {
-    let value: TOMLValue
-    var codingPath: [any CodingKey]
+    let node: CTomlNode
+    let document: TOMLParseResult
+    let path: CodingPath
+    var codingPath: [any CodingKey] { path.keys }
     var userInfo: [CodingUserInfoKey: Any]
     let options: DecodingOptions
 
-    init(value: TOMLValue, codingPath: [any CodingKey], userInfo: [CodingUserInfoKey: Any], options: DecodingOptions) {
-        self.value = value
-        self.codingPath = codingPath
+    /// The decoding plans for this decode, shared by every decoder and container below it.
+    let plans: DecodingPlans
+
+    /// Records the keys read from the root table, if this decodes the document's root.
+    let rootKeys: RootKeyRecorder?
+
+    init(
+        node: CTomlNode,
+        document: TOMLParseResult,
+        path: CodingPath,
+        userInfo: [CodingUserInfoKey: Any],
+        options: DecodingOptions,
+        plans: DecodingPlans,
+        rootKeys: RootKeyRecorder? = nil
+    ) {
+        self.node = node
+        self.document = document
+        self.path = path
         self.userInfo = userInfo
         self.options = options
+        self.plans = plans
+        self.rootKeys = rootKeys
     }
 
     func container<Key: CodingKey>(keyedBy type: Key.Type) throws -> KeyedDecodingContainer<Key> {
-        guard case .table(let dict) = value else {
+        guard node.type == CTOML_TABLE else {
             throw DecodingError.typeMismatch(
                 [String: Any].self,
                 DecodingError.Context(
                     codingPath: codingPath,
-                    debugDescription: "Expected table, found \(valueTypeName(value))"
+                    debugDescription: "Expected table, found \(node.typeName)"
                 )
             )
         }
 
         let container = TOMLKeyedDecodingContainer<Key>(
-            dict: dict,
-            codingPath: codingPath,
+            node: node,
+            document: document,
+            path: path,
             userInfo: userInfo,
-            options: options
+            options: options,
+            plans: plans,
+            rootKeys: rootKeys
         )
         return KeyedDecodingContainer(container)
     }
 
     func unkeyedContainer() throws -> any UnkeyedDecodingContainer {
-        guard case .array(let arr) = value else {
+        rootKeys?.requireAllKeys()
+        guard node.type == CTOML_ARRAY else {
             throw DecodingError.typeMismatch(
                 [Any].self,
                 DecodingError.Context(
                     codingPath: codingPath,
-                    debugDescription: "Expected array, found \(valueTypeName(value))"
+                    debugDescription: "Expected array, found \(node.typeName)"
                 )
             )
         }
 
         return TOMLUnkeyedDecodingContainer(
-            array: arr,
-            codingPath: codingPath,
+            array: node.data.array_value,
+            document: document,
+            path: path,
             userInfo: userInfo,
-            options: options
+            options: options,
+            plans: plans
         )
     }
 
     func singleValueContainer() throws -> any SingleValueDecodingContainer {
-        TOMLSingleValueDecodingContainer(
-            value: value,
-            codingPath: codingPath,
+        rootKeys?.requireAllKeys()
+        return TOMLSingleValueDecodingContainer(
+            node: node,
+            document: document,
+            path: path,
             userInfo: userInfo,
-            options: options
+            options: options,
+            plans: plans
         )
     }
+
+    /// Decodes a value from this decoder's node.
+    ///
+    /// Tables decoded as ``TOMLDecodable`` types are handed to ``TOMLDecodable/init(toml:)``.
+    /// Arrays of integers, floats, strings, and booleans are filled in a single loop,
+    /// and large arrays of other types are split into chunks decoded in parallel
+    /// when the array decoding strategy allows it.
+    func decode<T: Decodable>(_ type: T.Type) throws -> T {
+        if node.type == CTOML_TABLE, let decodableType = type as? any TOMLDecodable.Type {
+            rootKeys?.requireAllKeys()
+            let table = TOMLDocument.Table(
+                node: TOMLDocument.Node(
+                    node: node,
+                    document: document,
+                    options: options,
+                    userInfo: userInfo,
+                    plans: plans,
+                    parentPath: path
+                )
+            )
+            return try decodableType.init(toml: table) as! T
+        }
+        guard node.type == CTOML_ARRAY else {
+            return try T(from: self)
+        }
+        if let array = decodePrimitiveArray(type) {
+            return array
+        }
+        if case .concurrent(let minimumCount) = options.arrayDecodingStrategy,
+            node.data.array_value.count >= minimumCount,
+            let arrayType = type as? any ConcurrentlyDecodableArray.Type
+        {
+            return try arrayType.decodeConcurrently(from: self) as! T
+        }
+        return try T(from: self)
+    }
+
+    /// Decodes `[Int]`, `[Int64]`, `[Double]`, `[String]`, and `[Bool]`
+    /// without going through an unkeyed container.
+    ///
+    /// Returns `nil` for other types, or if any element has the wrong type,
+    /// in which case the caller falls back to `init(from:)` to report the error.
+    private func decodePrimitiveArray<T>(_ type: T.Type) -> T? {
+        if type == [Int].self {
+            return decodeElements { $0.type == CTOML_INTEGER ? Int($0.data.integer_value) : nil } as? T
+        }
+        if type == [Int64].self {
+            return decodeElements { $0.type == CTOML_INTEGER ? $0.data.integer_value : nil } as? T
+        }
+        if type == [Double].self {
+            return decodeElements { node -> Double? in
+                switch node.type {
+                case CTOML_FLOAT: return node.data.float_value
+                case CTOML_INTEGER: return Double(node.data.integer_value)
+                default: return nil
+                }
+            } as? T
+        }
+        if type == [String].self {
+            return decodeElements { node -> String? in
+                switch node.type {
+                case CTOML_STRING: return String(node.data.string_value)
+                case CTOML_NONE: return ""
+                default: return nil
+                }
+            } as? T
+        }
+        if type == [Bool].self {
+            return decodeElements { $0.type == CTOML_BOOLEAN ? $0.data.boolean_value : nil } as? T
+        }
+        return nil
+    }
+
+    private func decodeElements<Element>(_ convert: (CTomlNode) -> Element?) -> [Element]? {
+        let array = node.data.array_value
+        guard array.count > 0, let nodes = array.elements else { return [] }
+
+        var complete = true
+        let elements = [Element](unsafeUninitializedCapacity: array.count) { buffer, initializedCount in
+            for i in 0 ..< array.count {
+                guard let element = convert(nodes[i]) else {
+                    complete = false
+                    return
+                }
+                (buffer.baseAddress! + i).initialize(to: element)
+                initializedCount += 1
+            }
+        }
+        return complete ? elements : nil
+    }
+}
+
+// MARK: - Concurrent Array Decoding
+
+private protocol ConcurrentlyDecodableArray {
+    static func decodeConcurrently(from decoder: _TOMLDecoder) throws -> Self
+}
+
+extension Array: ConcurrentlyDecodableArray where Element: Decodable {
+    /// Decodes the elements of the decoder's array in chunks, one chunk per work item,
+    /// then concatenates the chunks in order.
+    /// Each chunk has its own ``DecodingPlans``,
+    /// so work items only share the process-wide plan cache once per key type.
+    ///
+    /// Each chunk stops at its first error,
+    /// and the error from the earliest failing chunk is rethrown,
+    /// so failures are reported for the same element as a serial decode.
+    fileprivate static func decodeConcurrently(from decoder: _TOMLDecoder) throws -> [Element] {
+        let array = decoder.node.data.array_value
+        let count = array.count
+        let chunkSize = Swift.max(1, count / (ProcessInfo.processInfo.activeProcessorCount * 4))
+        let chunkCount = (count + chunkSize - 1) / chunkSize
+        let options = decoder.options.serial
+
+        let chunks = UnsafeMutableBufferPointer<Result<[Element], any Error>>.allocate(capacity: chunkCount)
+        defer {
+            _ = chunks.deinitialize()
+            chunks.deallocate()
+        }
+
+        DispatchQueue.concurrentPerform(iterations: chunkCount) { chunk in
+            let start = chunk * chunkSize
+            let end = Swift.min(start + chunkSize, count)
+            var container = TOMLUnkeyedDecodingContainer(
+                array: array,
+                document: decoder.document,
+                path: decoder.path,
+                userInfo: decoder.userInfo,
+                options: options,
+                plans: DecodingPlans(keyDecodingStrategy: options.keyDecodingStrategy),
+                currentIndex: start
+            )
+            let result = Result<[Element], any Error> {
+                var elements: [Element] = []
+                elements.reserveCapacity(end - start)
+                while container.currentIndex < end {
+                    elements.append(try container.decode(Element.self))
+                }
+                return elements
+            }
+            (chunks.baseAddress! + chunk).initialize(to: result)
+        }
+
+        var elements: [Element] = []
+        elements.reserveCapacity(count)
+        for chunk in chunks {
+            elements.append(contentsOf: try chunk.get())
+        }
+        return elements
+    }
+}
+
+// MARK: - Dynamic Decoding
+
+extension TOMLValue: Decodable {
+    /// Decodes a value of whatever type the decoder holds.
+    ///
+    /// From a ``TOMLDecoder``, the value is converted straight from the parsed node,
+    /// keeping its TOML type, including dates and times.
+    /// Date and key decoding strategies don't apply.
+    ///
+    /// Other decoders don't expose the type of their value,
+    /// so tables, arrays, booleans, integers, floats, and strings are tried in turn.
+    public init(from decoder: any Decoder) throws {
+        if let decoder = decoder as? _TOMLDecoder {
+            decoder.rootKeys?.requireAllKeys()
+            self.init(decoder.node)
+            return
+        }
+
+        if let container = try? decoder.container(keyedBy: TOMLCodingKey.self) {
+            var table = Table(minimumCapacity: container.allKeys.count)
+            for key in container.allKeys {
+                table[key.stringValue] = try container.decode(TOMLValue.self, forKey: key)
+            }
+            self = .table(table)
+        } else if var container = try? decoder.unkeyedContainer() {
+            var array: [TOMLValue] = []
+            while !container.isAtEnd {
+                array.append(try container.decode(TOMLValue.self))
+            }
+            self = .array(array)
+        } else {
+            let container = try decoder.singleValueContainer()
+            if let value = try? container.decode(Bool.self) {
+                self = .boolean(value)
+            } else if let value = try? container.decode(Int64.self) {
+                self = .integer(value)
+            } else if let value = try? container.decode(Double.self) {
+                self = .float(value)
+            } else {
+                self = .string(try container.decode(String.self))
+            }
+        }
+    }
 }
 
 // MARK: - Helpers
 
-private func valueTypeName(_ value: TOMLValue) -> String {
-    switch value {
-    case .string: return "string"
-    case .integer: return "integer"
-    case .float: return "float"
-    case .boolean: return "boolean"
-    case .offsetDateTime: return "offset date-time"
-    case .localDateTime: return "local date-time"
-    case .localDate: return "local date"
-    case .localTime: return "local time"
-    case .array: return "array"
-    case .table: return "table"
+/// Interprets a local date or date-time in the current time zone.
+private func calendarDate(from node: CTomlNode) -> Date? {
+    var components = DateComponents()
+    switch node.type {
+    case CTOML_DATETIME:
+        let dt = node.data.datetime_value
+        components.year = Int(dt.date.year)
+        components.month = Int(dt.date.month)
+        components.day = Int(dt.date.day)
+        components.hour = Int(dt.time.hour)
+        components.minute = Int(dt.time.minute)
+        components.second = Int(dt.time.second)
+        components.nanosecond = Int(dt.time.nanosecond)
+    case CTOML_DATE:
+        let d = node.data.date_value
+        components.year = Int(d.year)
+        components.month = Int(d.month)
+        components.day = Int(d.day)
+    default:
+        return nil
+    }
+    return Calendar(identifier: .gregorian).date(from: components)
+}
+
+private extension CTomlNode {
+    var isLocalDateTime: Bool {
+        type == CTOML_DATETIME && !data.datetime_value.has_offset
     }
 }
 
 // MARK: - Keyed Decoding Container
 
 private struct TOMLKeyedDecodingContainer<Key: CodingKey>: KeyedDecodingContainerProtocol {
-    let dict: [String: TOMLValue]
-    var codingPath: [any CodingKey]
+    let node: CTomlNode
+    let document: TOMLParseResult
+    let path: CodingPath
+    var codingPath: [any CodingKey] { path.keys }
     let userInfo: [CodingUserInfoKey: Any]
     let options: DecodingOptions
+    let plans: DecodingPlans
+
+    private let plan: DecodingPlans.Resolved
+    private let rootKeys: RootKeyRecorder?
+
+    init(
+        node: CTomlNode,
+        document: TOMLParseResult,
+        path: CodingPath,
+        userInfo: [CodingUserInfoKey: Any],
+        options: DecodingOptions,
+        plans: DecodingPlans,
+        rootKeys: RootKeyRecorder? = nil
+    ) {
+        self.node = node
+        self.document = document
+        self.path = path
+        self.userInfo = userInfo
+        self.options = options
+        self.plans = plans
+        self.rootKeys = rootKeys
+        self.plan = plans.plan(for: Key.self)
+    }
+
+    private var table: CTomlTableData {
+        node.data.table_value
+    }
 
     var allKeys: [Key] {
-        dict.keys.compactMap { Key(stringValue: $0) }
+        rootKeys?.requireAllKeys()
+        let table = self.table
+        guard let keys = table.keys else { return [] }
+        return (0 ..< table.count).compactMap { Key(stringValue: String(keys[$0])) }
     }
 
     func contains(_ key: Key) -> Bool {
-        dict[convertKey(key)] != nil
+        index(forKey: key) != nil
     }
 
-    private func convertKey(_ key: Key) -> String {
-        switch options.keyDecodingStrategy {
-        case .useDefaultKeys:
-            return key.stringValue
-        case .convertFromSnakeCase:
-            return key.stringValue.convertFromSnakeCase()
-        }
+    private func entry(forKey key: Key) -> DecodingPlan.Entry {
+        let entry = plan.entry(forKey: key, in: table)
+        rootKeys?.record(entry.name)
+        return entry
     }
 
-    private func getValue(forKey key: Key) throws -> TOMLValue {
-        let keyString = convertKey(key)
-        guard let value = dict[keyString] else {
+    private func index(forKey key: Key) -> Int? {
+        entry(forKey: key).find(in: table)
+    }
+
+    private func getNode(forKey key: Key) throws -> CTomlNode {
+        let entry = entry(forKey: key)
+        guard let slot = entry.find(in: table) else {
             throw DecodingError.keyNotFound(
                 key,
                 DecodingError.Context(
                     codingPath: codingPath,
-                    debugDescription: "Key '\(keyString)' not found"
+                    debugDescription: "Key '\(entry.name)' not found"
                 )
             )
         }
-        return value
+        return table.values[slot]
     }
 
     func decodeNil(forKey key: Key) throws -> Bool {
@@ -531,27 +972,28 @@ private struct TOMLKeyedDecodingContainer<Key: CodingKey>: KeyedDecodingContaine
     }
 
     func decode(_ type: Bool.Type, forKey key: Key) throws -> Bool {
-        let value = try getValue(forKey: key)
-        guard case .boolean(let b) = value else {
-            throw typeMismatchError(type, value: value, key: key)
+        let node = try getNode(forKey: key)
+        guard node.type == CTOML_BOOLEAN else {
+            throw typeMismatchError(type, node: node, key: key)
         }
-        return b
+        return node.data.boolean_value
     }
 
     func decode(_ type: String.Type, forKey key: Key) throws -> String {
-        let value = try getValue(forKey: key)
-        guard case .string(let s) = value else {
-            throw typeMismatchError(type, value: value, key: key)
+        let node = try getNode(forKey: key)
+        switch node.type {
+        case CTOML_STRING: return String(node.data.string_value)
+        case CTOML_NONE: return ""
+        default: throw typeMismatchError(type, node: node, key: key)
         }
-        return s
     }
 
     func decode(_ type: Double.Type, forKey key: Key) throws -> Double {
-        let value = try getValue(forKey: key)
-        switch value {
-        case .float(let f): return f
-        case .integer(let i): return Double(i)
-        default: throw typeMismatchError(type, value: value, key: key)
+        let node = try getNode(forKey: key)
+        switch node.type {
+        case CTOML_FLOAT: return node.data.float_value
+        case CTOML_INTEGER: return Double(node.data.integer_value)
+        default: throw typeMismatchError(type, node: node, key: key)
         }
     }
 
@@ -576,11 +1018,11 @@ private struct TOMLKeyedDecodingContainer<Key: CodingKey>: KeyedDecodingContaine
     }
 
     func decode(_ type: Int64.Type, forKey key: Key) throws -> Int64 {
-        let value = try getValue(forKey: key)
-        guard case .integer(let i) = value else {
-            throw typeMismatchError(type, value: value, key: key)
+        let node = try getNode(forKey: key)
+        guard node.type == CTOML_INTEGER else {
+            throw typeMismatchError(type, node: node, key: key)
         }
-        return i
+        return node.data.integer_value
     }
 
     func decode(_ type: UInt.Type, forKey key: Key) throws -> UInt {
@@ -604,67 +1046,51 @@ private struct TOMLKeyedDecodingContainer<Key: CodingKey>: KeyedDecodingContaine
     }
 
     func decode<T: Decodable>(_ type: T.Type, forKey key: Key) throws -> T {
-        let value = try getValue(forKey: key)
+        let node = try getNode(forKey: key)
 
+        if type == TOMLValue.self {
+            return TOMLValue(node) as! T
+        }
         if type == Date.self {
-            return try decodeDate(from: value, forKey: key) as! T
+            return try decodeDate(from: node, forKey: key) as! T
         }
         if type == LocalDateTime.self {
-            guard case .localDateTime(let dt) = value else {
-                throw typeMismatchError(type, value: value, key: key)
+            guard node.isLocalDateTime else {
+                throw typeMismatchError(type, node: node, key: key)
             }
-            return dt as! T
+            return node.data.datetime_value.localDateTime as! T
         }
         if type == LocalDate.self {
-            guard case .localDate(let d) = value else {
-                throw typeMismatchError(type, value: value, key: key)
+            guard node.type == CTOML_DATE else {
+                throw typeMismatchError(type, node: node, key: key)
             }
-            return d as! T
+            return node.data.date_value.localDate as! T
         }
         if type == LocalTime.self {
-            guard case .localTime(let t) = value else {
-                throw typeMismatchError(type, value: value, key: key)
+            guard node.type == CTOML_TIME else {
+                throw typeMismatchError(type, node: node, key: key)
             }
-            return t as! T
+            return node.data.time_value.localTime as! T
         }
 
         let decoder = _TOMLDecoder(
-            value: value,
-            codingPath: codingPath + [key],
+            node: node,
+            document: document,
+            path: path.appending(key),
             userInfo: userInfo,
-            options: options
+            options: options,
+            plans: plans
         )
-        return try T(from: decoder)
+        return try decoder.decode(type)
     }
 
-    private func decodeDate(from value: TOMLValue, forKey key: Key) throws -> Date {
-        switch value {
-        case .offsetDateTime(let date):
-            return date
-        case .localDateTime(let dt):
-            var components = DateComponents()
-            components.year = dt.year
-            components.month = dt.month
-            components.day = dt.day
-            components.hour = dt.hour
-            components.minute = dt.minute
-            components.second = dt.second
-            components.nanosecond = dt.nanosecond
-            guard let date = Calendar(identifier: .gregorian).date(from: components) else {
-                throw DecodingError.dataCorrupted(
-                    DecodingError.Context(
-                        codingPath: codingPath + [key],
-                        debugDescription: "Invalid date components"
-                    )
-                )
+    private func decodeDate(from node: CTomlNode, forKey key: Key) throws -> Date {
+        switch node.type {
+        case CTOML_DATETIME, CTOML_DATE:
+            if node.type == CTOML_DATETIME, let date = node.data.datetime_value.offsetDate {
+                return date
             }
-            return date
-        case .localDate(let d):
-            var components = DateComponents()
-            components.year = d.year
-            components.month = d.month
-            components.day = d.day
-            guard let date = Calendar(identifier: .gregorian).date(from: components) else {
+            guard let date = calendarDate(from: node) else {
                 throw DecodingError.dataCorrupted(
                     DecodingError.Context(
                         codingPath: codingPath + [key],
@@ -673,17 +1099,17 @@ private struct TOMLKeyedDecodingContainer<Key: CodingKey>: KeyedDecodingContaine
                 )
             }
             return date
-        case .float(let f):
+        case CTOML_FLOAT:
             switch options.dateDecodingStrategy {
             case .secondsSince1970:
-                return Date(timeIntervalSince1970: f)
+                return Date(timeIntervalSince1970: node.data.float_value)
             case .millisecondsSince1970:
-                return Date(timeIntervalSince1970: f / 1000)
+                return Date(timeIntervalSince1970: node.data.float_value / 1000)
             default:
-                throw typeMismatchError(Date.self, value: value, key: key)
+                throw typeMismatchError(Date.self, node: node, key: key)
             }
         default:
-            throw typeMismatchError(Date.self, value: value, key: key)
+            throw typeMismatchError(Date.self, node: node, key: key)
         }
     }
 
@@ -691,59 +1117,68 @@ private struct TOMLKeyedDecodingContainer<Key: CodingKey>: KeyedDecodingContaine
         keyedBy type: NestedKey.Type,
         forKey key: Key
     ) throws -> KeyedDecodingContainer<NestedKey> {
-        let value = try getValue(forKey: key)
-        guard case .table(let dict) = value else {
-            throw typeMismatchError([String: Any].self, value: value, key: key)
+        let node = try getNode(forKey: key)
+        guard node.type == CTOML_TABLE else {
+            throw typeMismatchError([String: Any].self, node: node, key: key)
         }
 
         let container = TOMLKeyedDecodingContainer<NestedKey>(
-            dict: dict,
-            codingPath: codingPath + [key],
+            node: node,
+            document: document,
+            path: path.appending(key),
             userInfo: userInfo,
-            options: options
+            options: options,
+            plans: plans
         )
         return KeyedDecodingContainer(container)
     }
 
     func nestedUnkeyedContainer(forKey key: Key) throws -> any UnkeyedDecodingContainer {
-        let value = try getValue(forKey: key)
-        guard case .array(let arr) = value else {
-            throw typeMismatchError([Any].self, value: value, key: key)
+        let node = try getNode(forKey: key)
+        guard node.type == CTOML_ARRAY else {
+            throw typeMismatchError([Any].self, node: node, key: key)
         }
 
         return TOMLUnkeyedDecodingContainer(
-            array: arr,
-            codingPath: codingPath + [key],
+            array: node.data.array_value,
+            document: document,
+            path: path.appending(key),
             userInfo: userInfo,
-            options: options
+            options: options,
+            plans: plans
         )
     }
 
     func superDecoder() throws -> any Decoder {
-        _TOMLDecoder(
-            value: .table(dict),
-            codingPath: codingPath,
+        rootKeys?.requireAllKeys()
+        return _TOMLDecoder(
+            node: node,
+            document: document,
+            path: path,
             userInfo: userInfo,
-            options: options
+            options: options,
+            plans: plans
         )
     }
 
     func superDecoder(forKey key: Key) throws -> any Decoder {
-        let value = try getValue(forKey: key)
+        let node = try getNode(forKey: key)
         return _TOMLDecoder(
-            value: value,
-            codingPath: codingPath + [key],
+            node: node,
+            document: document,
+            path: path.appending(key),
             userInfo: userInfo,
-            options: options
+            options: options,
+            plans: plans
         )
     }
 
-    private func typeMismatchError<T>(_ type: T.Type, value: TOMLValue, key: Key) -> DecodingError {
+    private func typeMismatchError<T>(_ type: T.Type, node: CTomlNode, key: Key) -> DecodingError {
         DecodingError.typeMismatch(
             type,
             DecodingError.Context(
                 codingPath: codingPath + [key],
-                debugDescription: "Expected \(type), found \(valueTypeName(value))"
+                debugDescription: "Expected \(type), found \(node.typeName)"
             )
         )
     }
@@ -752,16 +1187,19 @@ private struct TOMLKeyedDecodingContainer<Key: CodingKey>: KeyedDecodingContaine
 // MARK: - Unkeyed Decoding Container
 
 private struct TOMLUnkeyedDecodingContainer: UnkeyedDecodingContainer {
-    let array: [TOMLValue]
-    var codingPath: [any CodingKey]
+    let array: CTomlArrayData
+    let document: TOMLParseResult
+    let path: CodingPath
+    var codingPath: [any CodingKey] { path.keys }
     let userInfo: [CodingUserInfoKey: Any]
     let options: DecodingOptions
+    let plans: DecodingPlans
 
     var count: Int? { array.count }
     var isAtEnd: Bool { currentIndex >= array.count }
     var currentIndex: Int = 0
 
-    private mutating func nextValue() throws -> TOMLValue {
+    private mutating func nextNode() throws -> CTomlNode {
         guard !isAtEnd else {
             throw DecodingError.valueNotFound(
                 Any.self,
@@ -771,9 +1209,9 @@ private struct TOMLUnkeyedDecodingContainer: UnkeyedDecodingContainer {
                 )
             )
         }
-        let value = array[currentIndex]
+        let node = array.elements[currentIndex]
         currentIndex += 1
-        return value
+        return node
     }
 
     mutating func decodeNil() throws -> Bool {
@@ -781,27 +1219,28 @@ private struct TOMLUnkeyedDecodingContainer: UnkeyedDecodingContainer {
     }
 
     mutating func decode(_ type: Bool.Type) throws -> Bool {
-        let value = try nextValue()
-        guard case .boolean(let b) = value else {
-            throw typeMismatchError(type, value: value)
+        let node = try nextNode()
+        guard node.type == CTOML_BOOLEAN else {
+            throw typeMismatchError(type, node: node)
         }
-        return b
+        return node.data.boolean_value
     }
 
     mutating func decode(_ type: String.Type) throws -> String {
-        let value = try nextValue()
-        guard case .string(let s) = value else {
-            throw typeMismatchError(type, value: value)
+        let node = try nextNode()
+        switch node.type {
+        case CTOML_STRING: return String(node.data.string_value)
+        case CTOML_NONE: return ""
+        default: throw typeMismatchError(type, node: node)
         }
-        return s
     }
 
     mutating func decode(_ type: Double.Type) throws -> Double {
-        let value = try nextValue()
-        switch value {
-        case .float(let f): return f
-        case .integer(let i): return Double(i)
-        default: throw typeMismatchError(type, value: value)
+        let node = try nextNode()
+        switch node.type {
+        case CTOML_FLOAT: return node.data.float_value
+        case CTOML_INTEGER: return Double(node.data.integer_value)
+        default: throw typeMismatchError(type, node: node)
         }
     }
 
@@ -826,11 +1265,11 @@ private struct TOMLUnkeyedDecodingContainer: UnkeyedDecodingContainer {
     }
 
     mutating func decode(_ type: Int64.Type) throws -> Int64 {
-        let value = try nextValue()
-        guard case .integer(let i) = value else {
-            throw typeMismatchError(type, value: value)
+        let node = try nextNode()
+        guard node.type == CTOML_INTEGER else {
+            throw typeMismatchError(type, node: node)
         }
-        return i
+        return node.data.integer_value
     }
 
     mutating func decode(_ type: UInt.Type) throws -> UInt {
@@ -854,67 +1293,51 @@ private struct TOMLUnkeyedDecodingContainer: UnkeyedDecodingContainer {
     }
 
     mutating func decode<T: Decodable>(_ type: T.Type) throws -> T {
-        let value = try nextValue()
+        let node = try nextNode()
 
+        if type == TOMLValue.self {
+            return TOMLValue(node) as! T
+        }
         if type == Date.self {
-            return try decodeDate(from: value) as! T
+            return try decodeDate(from: node) as! T
         }
         if type == LocalDateTime.self {
-            guard case .localDateTime(let dt) = value else {
-                throw typeMismatchError(type, value: value)
+            guard node.isLocalDateTime else {
+                throw typeMismatchError(type, node: node)
             }
-            return dt as! T
+            return node.data.datetime_value.localDateTime as! T
         }
         if type == LocalDate.self {
-            guard case .localDate(let d) = value else {
-                throw typeMismatchError(type, value: value)
+            guard node.type == CTOML_DATE else {
+                throw typeMismatchError(type, node: node)
             }
-            return d as! T
+            return node.data.date_value.localDate as! T
         }
         if type == LocalTime.self {
-            guard case .localTime(let t) = value else {
-                throw typeMismatchError(type, value: value)
+            guard node.type == CTOML_TIME else {
+                throw typeMismatchError(type, node: node)
             }
-            return t as! T
+            return node.data.time_value.localTime as! T
         }
 
         let decoder = _TOMLDecoder(
-            value: value,
-            codingPath: codingPath + [TOMLCodingKey(index: currentIndex - 1)],
+            node: node,
+            document: document,
+            path: path.appending(index: currentIndex - 1),
             userInfo: userInfo,
-            options: options
+            options: options,
+            plans: plans
         )
-        return try T(from: decoder)
+        return try decoder.decode(type)
     }
 
-    private func decodeDate(from value: TOMLValue) throws -> Date {
-        switch value {
-        case .offsetDateTime(let date):
-            return date
-        case .localDateTime(let dt):
-            var components = DateComponents()
-            components.year = dt.year
-            components.month = dt.month
-            components.day = dt.day
-            components.hour = dt.hour
-            components.minute = dt.minute
-            components.second = dt.second
-            components.nanosecond = dt.nanosecond
-            guard let date = Calendar(identifier: .gregorian).date(from: components) else {
-                throw DecodingError.dataCorrupted(
-                    DecodingError.Context(
-                        codingPath: codingPath + [TOMLCodingKey(index: currentIndex - 1)],
-                        debugDescription: "Invalid date components"
-                    )
-                )
+    private func decodeDate(from node: CTomlNode) throws -> Date {
+        switch node.type {
+        case CTOML_DATETIME, CTOML_DATE:
+            if node.type == CTOML_DATETIME, let date = node.data.datetime_value.offsetDate {
+                return date
             }
-            return date
-        case .localDate(let d):
-            var components = DateComponents()
-            components.year = d.year
-            components.month = d.month
-            components.day = d.day
-            guard let date = Calendar(identifier: .gregorian).date(from: components) else {
+            guard let date = calendarDate(from: node) else {
                 throw DecodingError.dataCorrupted(
                     DecodingError.Context(
                         codingPath: codingPath + [TOMLCodingKey(index: currentIndex - 1)],
@@ -924,57 +1347,63 @@ private struct TOMLUnkeyedDecodingContainer: UnkeyedDecodingContainer {
             }
             return date
         default:
-            throw typeMismatchError(Date.self, value: value)
+            throw typeMismatchError(Date.self, node: node)
         }
     }
 
     mutating func nestedContainer<NestedKey: CodingKey>(
         keyedBy type: NestedKey.Type
     ) throws -> KeyedDecodingContainer<NestedKey> {
-        let value = try nextValue()
-        guard case .table(let dict) = value else {
-            throw typeMismatchError([String: Any].self, value: value)
+        let node = try nextNode()
+        guard node.type == CTOML_TABLE else {
+            throw typeMismatchError([String: Any].self, node: node)
         }
 
         let container = TOMLKeyedDecodingContainer<NestedKey>(
-            dict: dict,
-            codingPath: codingPath + [TOMLCodingKey(index: currentIndex - 1)],
+            node: node,
+            document: document,
+            path: path.appending(index: currentIndex - 1),
             userInfo: userInfo,
-            options: options
+            options: options,
+            plans: plans
         )
         return KeyedDecodingContainer(container)
     }
 
     mutating func nestedUnkeyedContainer() throws -> any UnkeyedDecodingContainer {
-        let value = try nextValue()
-        guard case .array(let arr) = value else {
-            throw typeMismatchError([Any].self, value: value)
+        let node = try nextNode()
+        guard node.type == CTOML_ARRAY else {
+            throw typeMismatchError([Any].self, node: node)
         }
 
         return TOMLUnkeyedDecodingContainer(
-            array: arr,
-            codingPath: codingPath + [TOMLCodingKey(index: currentIndex - 1)],
+            array: node.data.array_value,
+            document: document,
+            path: path.appending(index: currentIndex - 1),
             userInfo: userInfo,
-            options: options
+            options: options,
+            plans: plans
         )
     }
 
     mutating func superDecoder() throws -> any Decoder {
-        let value = try nextValue()
+        let node = try nextNode()
         return _TOMLDecoder(
-            value: value,
-            codingPath: codingPath + [TOMLCodingKey(index: currentIndex - 1)],
+            node: node,
+            document: document,
+            path: path.appending(index: currentIndex - 1),
             userInfo: userInfo,
-            options: options
+            options: options,
+            plans: plans
         )
     }
 
-    private func typeMismatchError<T>(_ type: T.Type, value: TOMLValue) -> DecodingError {
+    private func typeMismatchError<T>(_ type: T.Type, node: CTomlNode) -> DecodingError {
         DecodingError.typeMismatch(
             type,
             DecodingError.Context(
                 codingPath: codingPath + [TOMLCodingKey(index: currentIndex)],
-                debugDescription: "Expected \(type), found \(valueTypeName(value))"
+                debugDescription: "Expected \(type), found \(node.typeName)"
             )
         )
     }
@@ -983,33 +1412,37 @@ private struct TOMLUnkeyedDecodingContainer: UnkeyedDecodingContainer {
 // MARK: - Single Value Decoding Container
 
 private struct TOMLSingleValueDecodingContainer: SingleValueDecodingContainer {
-    let value: TOMLValue
-    var codingPath: [any CodingKey]
+    let node: CTomlNode
+    let document: TOMLParseResult
+    let path: CodingPath
+    var codingPath: [any CodingKey] { path.keys }
     let userInfo: [CodingUserInfoKey: Any]
     let options: DecodingOptions
+    let plans: DecodingPlans
 
     func decodeNil() -> Bool {
         false
     }
 
     func decode(_ type: Bool.Type) throws -> Bool {
-        guard case .boolean(let b) = value else {
+        guard node.type == CTOML_BOOLEAN else {
             throw typeMismatchError(type)
         }
-        return b
+        return node.data.boolean_value
     }
 
     func decode(_ type: String.Type) throws -> String {
-        guard case .string(let s) = value else {
-            throw typeMismatchError(type)
+        switch node.type {
+        case CTOML_STRING: return String(node.data.string_value)
+        case CTOML_NONE: return ""
+        default: throw typeMismatchError(type)
         }
-        return s
     }
 
     func decode(_ type: Double.Type) throws -> Double {
-        switch value {
-        case .float(let f): return f
-        case .integer(let i): return Double(i)
+        switch node.type {
+        case CTOML_FLOAT: return node.data.float_value
+        case CTOML_INTEGER: return Double(node.data.integer_value)
         default: throw typeMismatchError(type)
         }
     }
@@ -1035,10 +1468,10 @@ private struct TOMLSingleValueDecodingContainer: SingleValueDecodingContainer {
     }
 
     func decode(_ type: Int64.Type) throws -> Int64 {
-        guard case .integer(let i) = value else {
+        guard node.type == CTOML_INTEGER else {
             throw typeMismatchError(type)
         }
-        return i
+        return node.data.integer_value
     }
 
     func decode(_ type: UInt.Type) throws -> UInt {
@@ -1066,61 +1499,42 @@ private struct TOMLSingleValueDecodingContainer: SingleValueDecodingContainer {
             return try decodeDate() as! T
         }
         if type == LocalDateTime.self {
-            guard case .localDateTime(let dt) = value else {
+            guard node.isLocalDateTime else {
                 throw typeMismatchError(type)
             }
-            return dt as! T
+            return node.data.datetime_value.localDateTime as! T
         }
         if type == LocalDate.self {
-            guard case .localDate(let d) = value else {
+            guard node.type == CTOML_DATE else {
                 throw typeMismatchError(type)
             }
-            return d as! T
+            return node.data.date_value.localDate as! T
         }
         if type == LocalTime.self {
-            guard case .localTime(let t) = value else {
+            guard node.type == CTOML_TIME else {
                 throw typeMismatchError(type)
             }
-            return t as! T
+            return node.data.time_value.localTime as! T
         }
 
         let decoder = _TOMLDecoder(
-            value: value,
-            codingPath: codingPath,
+            node: node,
+            document: document,
+            path: path,
             userInfo: userInfo,
-            options: options
+            options: options,
+            plans: plans
         )
-        return try T(from: decoder)
+        return try decoder.decode(type)
     }
 
     private func decodeDate() throws -> Date {
-        switch value {
-        case .offsetDateTime(let date):
-            return date
-        case .localDateTime(let dt):
-            var components = DateComponents()
-            components.year = dt.year
-            components.month = dt.month
-            components.day = dt.day
-            components.hour = dt.hour
-            components.minute = dt.minute
-            components.second = dt.second
-            components.nanosecond = dt.nanosecond
-            guard let date = Calendar(identifier: .gregorian).date(from: components) else {
-                throw DecodingError.dataCorrupted(
-                    DecodingError.Context(
-                        codingPath: codingPath,
-                        debugDescription: "Invalid date components"
-                    )
-                )
+        switch node.type {
+        case CTOML_DATETIME, CTOML_DATE:
+            if node.type == CTOML_DATETIME, let date = node.data.datetime_value.offsetDate {
+                return date
             }
-            return date
-        case .localDate(let d):
-            var components = DateComponents()
-            components.year = d.year
-            components.month = d.month
-            components.day = d.day
-            guard let date = Calendar(identifier: .gregorian).date(from: components) else {
+            guard let date = calendarDate(from: node) else {
                 throw DecodingError.dataCorrupted(
                     DecodingError.Context(
                         codingPath: codingPath,
@@ -1139,7 +1553,7 @@ private struct TOMLSingleValueDecodingContainer: SingleValueDecodingContainer {
             type,
             DecodingError.Context(
                 codingPath: codingPath,
-                debugDescription: "Expected \(type), found \(valueTypeName(value))"
+                debugDescription: "Expected \(type), found \(node.typeName)"
             )
         )
     }
@@ -1147,7 +1561,7 @@ private struct TOMLSingleValueDecodingContainer: SingleValueDecodingContainer {
 
 // MARK: - String Extensions
 
-private extension String {
+extension String {
     func convertFromSnakeCase() -> String {
         var result = ""
         var capitalizeNext = false
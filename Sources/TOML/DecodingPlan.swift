@@ -0,0 +1,284 @@
+import CTomlPlusPlus
+import Foundation
+
+/// Key lookups recorded for one `CodingKey` type under one key decoding strategy.
+///
+/// `Decodable` types ask for the same keys, in the same order, every time they're decoded.
+/// The first time a key is requested, the plan resolves it once —
+/// applying the key decoding strategy and storing the result as contiguous UTF-8 —
+/// and records the slot the key was found at.
+/// Later lookups reuse the resolved bytes,
+/// and check the recorded slot before searching the table,
+/// so for documents with the same shape, a key is found with a single comparison.
+///
+/// Each decode takes a ``snapshot`` of the plan the first time it needs it, through ``DecodingPlans``,
+/// so keyed containers find keys already in the plan without taking a lock.
+final class DecodingPlan: @unchecked Sendable {
+    /// A resolved key.
+    ///
+    /// Keys are matched against the parser's keys byte for byte,
+    /// so no Swift strings are created for the keys in a table.
+    struct Entry {
+        /// The key as it appears in TOML, stored as contiguous UTF-8.
+        let name: String
+
+        /// The slot the key was found at when it was resolved, or `-1` if it wasn't found.
+        let slot: Int
+
+        init(name: String, slot: Int = -1) {
+            var name = name
+            name.makeContiguousUTF8()
+            self.name = name
+            self.slot = slot
+        }
+
+        /// Returns the key's slot in a table, or `nil` if the table doesn't contain it.
+        func find(in table: CTomlTableData) -> Int? {
+            var table = table
+            var name = self.name
+            let found = name.withUTF8 { utf8 in
+                if slot >= 0, slot < table.count, Entry.matches(table.keys[slot], utf8) {
+                    return slot
+                }
+                return utf8.withMemoryRebound(to: CChar.self) { chars in
+                    ctoml_table_find(&table, chars.baseAddress, chars.count)
+                }
+            }
+            return found >= 0 ? found : nil
+        }
+
+        private static func matches(_ key: CTomlString, _ utf8: UnsafeBufferPointer<UInt8>) -> Bool {
+            guard key.length == utf8.count else { return false }
+            guard key.length > 0 else { return true }
+            return memcmp(utf8.baseAddress, key.data, key.length) == 0
+        }
+    }
+
+    /// The maximum number of keys recorded for a single plan.
+    ///
+    /// Key types with unbounded key sets, such as dictionary keys,
+    /// stop being recorded once they reach this many.
+    static let maximumEntries = 1024
+
+    private let keyDecodingStrategy: TOMLDecoder.KeyDecodingStrategy
+    private let lock = NSLock()
+    private var entries: [String: Entry] = [:]
+
+    init(keyDecodingStrategy: TOMLDecoder.KeyDecodingStrategy) {
+        self.keyDecodingStrategy = keyDecodingStrategy
+    }
+
+    /// The keys resolved so far, indexed by `CodingKey.stringValue`.
+    var snapshot: [String: Entry] {
+        lock.lock()
+        defer { lock.unlock() }
+        return entries
+    }
+
+    /// Resolves a key that isn't in a snapshot and records it for later decodes.
+    func resolve(_ key: any CodingKey, in table: CTomlTableData) -> Entry {
+        let stringValue = key.stringValue
+        let name: String
+        switch keyDecodingStrategy {
+        case .useDefaultKeys:
+            name = stringValue
+        case .convertFromSnakeCase:
+            name = stringValue.convertFromSnakeCase()
+        }
+
+        var entry = Entry(name: name)
+        if let slot = entry.find(in: table) {
+            entry = Entry(name: entry.name, slot: slot)
+        }
+
+        lock.lock()
+        if entries[stringValue] == nil, entries.count < DecodingPlan.maximumEntries {
+            entries[stringValue] = entry
+        }
+        lock.unlock()
+        return entry
+    }
+}
+
+// MARK: - Plan Cache
+
+/// The process-wide collection of decoding plans,
+/// one for each combination of `CodingKey` type and key decoding strategy.
+final class DecodingPlanCache: @unchecked Sendable {
+    static let shared = DecodingPlanCache()
+
+    private struct PlanID: Hashable {
+        let keyType: ObjectIdentifier
+        let keyDecodingStrategy: TOMLDecoder.KeyDecodingStrategy
+    }
+
+    private let lock = NSLock()
+    private var plans: [PlanID: DecodingPlan] = [:]
+
+    func plan(
+        for keyType: any CodingKey.Type,
+        keyDecodingStrategy: TOMLDecoder.KeyDecodingStrategy
+    ) -> DecodingPlan {
+        let id = PlanID(keyType: ObjectIdentifier(keyType), keyDecodingStrategy: keyDecodingStrategy)
+
+        lock.lock()
+        defer { lock.unlock() }
+        if let plan = plans[id] {
+            return plan
+        }
+        let plan = DecodingPlan(keyDecodingStrategy: keyDecodingStrategy)
+        plans[id] = plan
+        return plan
+    }
+}
+
+// MARK: - Plans for One Decode
+
+/// The decoding plans used by one decode,
+/// looked up in ``DecodingPlanCache`` once per `CodingKey` type rather than once per table.
+///
+/// Each plan is held with its own copy of the keys resolved so far,
+/// so keyed containers don't take a lock or copy the plan's keys when they're created.
+/// Instances aren't thread-safe;
+/// when a decode splits an array across threads, each work item has its own.
+final class DecodingPlans {
+    /// A plan and the keys this decode has resolved with it.
+    final class Resolved {
+        private let plan: DecodingPlan
+        private var entries: [String: DecodingPlan.Entry]
+
+        init(plan: DecodingPlan) {
+            self.plan = plan
+            self.entries = plan.snapshot
+        }
+
+        /// Returns the resolved key, resolving it with the shared plan the first time it's requested.
+        func entry(forKey key: any CodingKey, in table: CTomlTableData) -> DecodingPlan.Entry {
+            let stringValue = key.stringValue
+            if let entry = entries[stringValue] {
+                return entry
+            }
+            let entry = plan.resolve(key, in: table)
+            if entries.count < DecodingPlan.maximumEntries {
+                entries[stringValue] = entry
+            }
+            return entry
+        }
+    }
+
+    private let keyDecodingStrategy: TOMLDecoder.KeyDecodingStrategy
+    private var plans: [ObjectIdentifier: Resolved] = [:]
+
+    init(keyDecodingStrategy: TOMLDecoder.KeyDecodingStrategy) {
+        self.keyDecodingStrategy = keyDecodingStrategy
+    }
+
+    /// Returns the plan for a `CodingKey` type.
+    func plan(for keyType: any CodingKey.Type) -> Resolved {
+        let id = ObjectIdentifier(keyType)
+        if let plan = plans[id] {
+            return plan
+        }
+        let plan = Resolved(
+            plan: DecodingPlanCache.shared.plan(for: keyType, keyDecodingStrategy: keyDecodingStrategy)
+        )
+        plans[id] = plan
+        return plan
+    }
+}
+
+// MARK: - Root Key Plans
+
+/// The root keys a `Decodable` type reads, recorded after it's decoded from a whole document.
+///
+/// Types usually read a small, fixed set of root keys,
+/// so once a type has been decoded,
+/// later decodes only convert those keys' subtrees from the parser's output
+/// and skip the rest of the document.
+final class RootKeyPlan: @unchecked Sendable {
+    private let lock = NSLock()
+    private var keys: Set<String>?
+    private var requiresAllKeys = false
+
+    /// The root keys to convert, or `nil` if the whole document should be converted.
+    var selectedKeys: [String]? {
+        lock.lock()
+        defer { lock.unlock() }
+        guard !requiresAllKeys, let keys else { return nil }
+        return Array(keys)
+    }
+
+    /// Adds the keys read during a decode of the whole document.
+    func update(with recorder: RootKeyRecorder) {
+        lock.lock()
+        defer { lock.unlock() }
+        if recorder.requiresAllKeys {
+            requiresAllKeys = true
+        } else {
+            keys = keys?.union(recorder.keys) ?? recorder.keys
+        }
+    }
+}
+
+/// Tracks the root keys read during a single decode.
+///
+/// When decoding from a document converted with only some root keys,
+/// reading any other key, or asking for the root table as a whole,
+/// marks the decode as a miss, and the caller decodes again from the whole document.
+final class RootKeyRecorder {
+    private let selectedKeys: Set<String>?
+    private(set) var keys: Set<String> = []
+    private(set) var requiresAllKeys = false
+    private(set) var missed = false
+
+    init(selectedKeys: [String]?) {
+        self.selectedKeys = selectedKeys.map(Set.init)
+    }
+
+    /// Records a lookup of a root key, by its name in the document.
+    func record(_ name: String) {
+        keys.insert(name)
+        if let selectedKeys, !selectedKeys.contains(name) {
+            missed = true
+        }
+    }
+
+    /// Records that the root table was read in a way that needs all of its keys,
+    /// such as through `allKeys` or a single value container.
+    func requireAllKeys() {
+        requiresAllKeys = true
+        if selectedKeys != nil {
+            missed = true
+        }
+    }
+}
+
+/// The process-wide collection of root key plans,
+/// one for each combination of `Decodable` type and key decoding strategy.
+final class RootKeyPlanCache: @unchecked Sendable {
+    static let shared = RootKeyPlanCache()
+
+    private struct PlanID: Hashable {
+        let type: ObjectIdentifier
+        let keyDecodingStrategy: TOMLDecoder.KeyDecodingStrategy
+    }
+
+    private let lock = NSLock()
+    private var plans: [PlanID: RootKeyPlan] = [:]
+
+    func plan(
+        for type: any Decodable.Type,
+        keyDecodingStrategy: TOMLDecoder.KeyDecodingStrategy
+    ) -> RootKeyPlan {
+        let id = PlanID(type: ObjectIdentifier(type), keyDecodingStrategy: keyDecodingStrategy)
+
+        lock.lock()
+        defer { lock.unlock() }
+        if let plan = plans[id] {
+            return plan
+        }
+        let plan = RootKeyPlan()
+        plans[id] = plan
+        return plan
+    }
+}
@@ -0,0 +1,373 @@
+import CTomlPlusPlus
+import Foundation
+
+/// A parsed TOML document whose values are converted lazily, as they're accessed.
+///
+/// Decoding a ``TOMLValue`` converts every string, table, and array in a document up front.
+/// A `TOMLDocument` instead keeps the parser's output
+/// and only converts the scalars, tables, and arrays you actually read,
+/// so looking up a handful of values in a large document
+/// costs time proportional to what you touch.
+///
+/// ## Usage
+///
+/// ```swift
+/// let document = try TOMLDocument(string: """
+///     [server]
+///     host = "localhost"
+///     port = 8080
+///     """)
+///
+/// let port = document["server"]?["port"]?.integer // 8080
+/// ```
+///
+/// Nodes, tables, and arrays keep their document alive,
+/// so they remain valid after the document itself goes out of scope.
+public final class TOMLDocument: @unchecked Sendable {
+    let result: TOMLParseResult
+
+    init(result: TOMLParseResult) {
+        self.result = result
+    }
+
+    /// Parses a TOML string.
+    ///
+    /// - Parameters:
+    ///   - string: A string containing TOML content.
+    ///   - limits: The limits the document is checked against, as when decoding with ``TOMLDecoder``.
+    /// - Throws: ``TOMLDecodingError`` if the string isn't valid TOML or exceeds `limits`.
+    public convenience init(string: String, limits: TOMLDecoder.DecodingLimits = .default) throws {
+        var string = string
+        let result = try string.withUTF8 { utf8 in
+            try limits.validateInputSize(utf8.count)
+            return try TOMLParseResult(parsing: UnsafeRawBufferPointer(utf8))
+        }
+        try limits.validate(result.root)
+        self.init(result: result)
+    }
+
+    /// Parses UTF-8 encoded TOML, such as `Data` or a `[UInt8]` array.
+    ///
+    /// - Parameters:
+    ///   - bytes: UTF-8 encoded TOML data.
+    ///   - limits: The limits the document is checked against, as when decoding with ``TOMLDecoder``.
+    /// - Throws: ``TOMLDecodingError`` if the bytes aren't valid TOML or exceed `limits`.
+    public convenience init(bytes: some ContiguousBytes, limits: TOMLDecoder.DecodingLimits = .default) throws {
+        let result = try bytes.withUnsafeBytes { buffer in
+            try limits.validateInputSize(buffer.count)
+            return try TOMLParseResult(parsing: buffer)
+        }
+        try limits.validate(result.root)
+        self.init(result: result)
+    }
+
+    /// The document's root table.
+    public var root: Table {
+        Table(node: Node(node: result.root, document: result))
+    }
+
+    /// Returns the value for a top-level key, if it exists.
+    public subscript(key: String) -> Node? {
+        root[key]
+    }
+
+    /// Converts the entire document into a ``TOMLValue``.
+    public var value: TOMLValue {
+        TOMLValue(result.root)
+    }
+}
+
+// MARK: - Formatting
+
+extension TOMLDocument {
+    /// A text format that a document can be written in.
+    public enum Format: Sendable {
+        /// TOML.
+        case toml
+        /// JSON, with dates and times as strings.
+        case json
+        /// YAML, with dates and times as strings.
+        case yaml
+
+        var cFormat: CTomlFormat {
+            switch self {
+            case .toml: return CTOML_FORMAT_TOML
+            case .json: return CTOML_FORMAT_JSON
+            case .yaml: return CTOML_FORMAT_YAML
+            }
+        }
+    }
+
+    /// Writes the document in a format to a sink, using toml++'s formatters.
+    ///
+    /// The document is formatted straight from the parser's output,
+    /// without converting any of it to Swift values,
+    /// and the output is passed to the sink in chunks as it's produced.
+    /// Keys are written in sorted order.
+    ///
+    /// - Parameters:
+    ///   - format: The format to write.
+    ///   - sink: The sink to write to, which is flushed once the document has been written.
+    /// - Throws: An error thrown by the sink, or ``TOMLEncodingError`` if formatting fails.
+    public func write(as format: Format, to sink: any TOMLOutputSink) throws {
+        try result.format(format.cFormat, to: sink)
+    }
+
+    /// Returns the document written in a format, using toml++'s formatters.
+    ///
+    /// - Parameter format: The format to write.
+    /// - Returns: The UTF-8 encoded output.
+    /// - Throws: ``TOMLEncodingError`` if formatting fails.
+    public func data(as format: Format) throws -> Data {
+        let sink = TOMLBytesSink()
+        try write(as: format, to: sink)
+        return Data(sink.bytes)
+    }
+}
+
+// MARK: - Node
+
+extension TOMLDocument {
+    /// A value in a ``TOMLDocument``.
+    ///
+    /// Accessors return `nil` when the value has a different type;
+    /// nothing is converted until an accessor is called.
+    public struct Node: @unchecked Sendable {
+        let node: CTomlNode
+        let document: TOMLParseResult
+
+        /// The options and user info used to decode `Decodable` values from this node.
+        var options = DecodingOptions.default
+        var userInfo: [CodingUserInfoKey: Any] = [:]
+
+        /// The decoding plans of the decode this node was handed to, if any.
+        ///
+        /// Plans aren't thread-safe, so nodes from a ``TOMLDocument``,
+        /// which may be read on any thread, don't have one.
+        var plans: DecodingPlans?
+
+        /// The coding path of the table or array holding this node,
+        /// and the node's place in it, for errors reported while decoding.
+        var parentPath = CodingPath.root
+        var location = Location.root
+
+        /// Where a node is in its parent.
+        enum Location {
+            case root
+            case key(String)
+            case index(Int)
+        }
+
+        /// The coding path of this node, built only when it's needed.
+        var path: CodingPath {
+            switch location {
+            case .root: return parentPath
+            case .key(let key): return parentPath.appending(TOMLCodingKey(stringValue: key))
+            case .index(let index): return parentPath.appending(index: index)
+            }
+        }
+
+        /// Returns a node for one of this node's children, with the same decoding context.
+        func child(_ node: CTomlNode, at location: Location) -> Node {
+            Node(
+                node: node,
+                document: document,
+                options: options,
+                userInfo: userInfo,
+                plans: plans,
+                parentPath: path,
+                location: location
+            )
+        }
+
+        /// The string value, if this is a string.
+        public var string: String? {
+            node.type == CTOML_STRING ? String(node.data.string_value) : nil
+        }
+
+        /// The integer value, if this is an integer.
+        public var integer: Int64? {
+            node.type == CTOML_INTEGER ? node.data.integer_value : nil
+        }
+
+        /// The floating-point value, if this is a float.
+        public var float: Double? {
+            node.type == CTOML_FLOAT ? node.data.float_value : nil
+        }
+
+        /// The Boolean value, if this is a boolean.
+        public var boolean: Bool? {
+            node.type == CTOML_BOOLEAN ? node.data.boolean_value : nil
+        }
+
+        /// The instant, if this is an offset date-time.
+        public var offsetDateTime: Date? {
+            node.type == CTOML_DATETIME ? node.data.datetime_value.offsetDate : nil
+        }
+
+        /// The local date-time, if this is a date-time without an offset.
+        public var localDateTime: LocalDateTime? {
+            guard node.type == CTOML_DATETIME, !node.data.datetime_value.has_offset else { return nil }
+            return node.data.datetime_value.localDateTime
+        }
+
+        /// The local date, if this is a date.
+        public var localDate: LocalDate? {
+            node.type == CTOML_DATE ? node.data.date_value.localDate : nil
+        }
+
+        /// The local time, if this is a time.
+        public var localTime: LocalTime? {
+            node.type == CTOML_TIME ? node.data.time_value.localTime : nil
+        }
+
+        /// The table, if this is a table.
+        public var table: Table? {
+            node.type == CTOML_TABLE ? Table(node: self) : nil
+        }
+
+        /// The array, if this is an array.
+        public var array: Array? {
+            node.type == CTOML_ARRAY ? Array(node: self) : nil
+        }
+
+        /// Returns the value for a key, if this is a table containing it.
+        public subscript(key: String) -> Node? {
+            table?[key]
+        }
+
+        /// Returns the element at an index, if this is an array and the index is in bounds.
+        public subscript(index: Int) -> Node? {
+            guard let array, array.indices.contains(index) else { return nil }
+            return array[index]
+        }
+
+        /// Converts this value and everything beneath it into a ``TOMLValue``.
+        public var value: TOMLValue {
+            TOMLValue(node)
+        }
+    }
+}
+
+// MARK: - Table
+
+extension TOMLDocument {
+    /// A table in a ``TOMLDocument``.
+    ///
+    /// Keys are looked up without converting the rest of the table.
+    /// Iterating yields key-value pairs in the order their keys appear in the document,
+    /// the same order as in the table of the document's ``TOMLValue``.
+    public struct Table: RandomAccessCollection, @unchecked Sendable {
+        let node: Node
+
+        private var data: CTomlTableData {
+            node.node.data.table_value
+        }
+
+        public var startIndex: Int { 0 }
+        public var endIndex: Int { data.count }
+
+        public subscript(position: Int) -> (key: String, value: Node) {
+            precondition(indices.contains(position), "Index out of range")
+            let data = self.data
+            // Entries are stored sorted by key, so they're read back in document order.
+            let i = data.order.map { $0[position] } ?? position
+            let key = String(data.keys[i])
+            return (key, node.child(data.values[i], at: .key(key)))
+        }
+
+        /// Returns the value for a key, if the table contains it.
+        public subscript(key: String) -> Node? {
+            var data = self.data
+            var key = key
+            let slot = key.withUTF8 { utf8 in
+                utf8.withMemoryRebound(to: CChar.self) { chars in
+                    ctoml_table_find(&data, chars.baseAddress, chars.count)
+                }
+            }
+            guard slot >= 0 else { return nil }
+            return node.child(data.values[slot], at: .key(key))
+        }
+
+        /// The table's keys, in document order.
+        public var keys: [String] {
+            map(\.key)
+        }
+    }
+}
+
+// MARK: - Array
+
+extension TOMLDocument {
+    /// An array in a ``TOMLDocument``.
+    ///
+    /// Elements are converted only when accessed.
+    public struct Array: RandomAccessCollection, @unchecked Sendable {
+        let node: Node
+
+        private var data: CTomlArrayData {
+            node.node.data.array_value
+        }
+
+        public var startIndex: Int { 0 }
+        public var endIndex: Int { data.count }
+
+        public subscript(position: Int) -> Node {
+            precondition(indices.contains(position), "Index out of range")
+            return node.child(data.elements[position], at: .index(position))
+        }
+    }
+}
+
+// MARK: - Materialization
+
+extension TOMLValue {
+    /// Converts a node and everything beneath it.
+    init(_ node: CTomlNode) {
+        switch node.type {
+        case CTOML_STRING:
+            self = .string(String(node.data.string_value))
+        case CTOML_INTEGER:
+            self = .integer(node.data.integer_value)
+        case CTOML_FLOAT:
+            self = .float(node.data.float_value)
+        case CTOML_BOOLEAN:
+            self = .boolean(node.data.boolean_value)
+        case CTOML_DATE:
+            self = .localDate(node.data.date_value.localDate)
+        case CTOML_TIME:
+            self = .localTime(node.data.time_value.localTime)
+        case CTOML_DATETIME:
+            let dt = node.data.datetime_value
+            if let date = dt.offsetDate {
+                self = .offsetDateTime(date)
+            } else {
+                self = .localDateTime(dt.localDateTime)
+            }
+        case CTOML_ARRAY:
+            let array = node.data.array_value
+            var values: [TOMLValue] = []
+            values.reserveCapacity(array.count)
+            if let elements = array.elements {
+                for i in 0 ..< array.count {
+                    values.append(TOMLValue(elements[i]))
+                }
+            }
+            self = .array(values)
+        case CTOML_TABLE:
+            let table = node.data.table_value
+            var entries: ContiguousArray<Table.Element> = []
+            entries.reserveCapacity(table.count)
+            // Entries are stored sorted by key, so they're read back in document order.
+            if let tableKeys = table.keys, let tableValues = table.values {
+                for position in 0 ..< table.count {
+                    let i = table.order.map { $0[position] } ?? position
+                    entries.append((String(tableKeys[i]), TOMLValue(tableValues[i])))
+                }
+            }
+            self = .table(Table(uniqueEntries: entries))
+        default:
+            self = .string("")
+        }
+    }
+}
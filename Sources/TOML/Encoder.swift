@@ -111,14 +111,78 @@ public final class TOMLEncoder {
 
         /// Sort keys alphabetically in tables.
         ///
-        /// This produces deterministic output that's easier to diff
-        /// and useful for version control.
+        /// Without this option, keys are written in the order they're encoded,
+        /// which for synthesized `Encodable` conformances is declaration order.
         public static let sortedKeys = OutputFormatting(rawValue: 1 << 0)
 
         /// Format the output with additional whitespace for readability.
         public static let prettyPrinted = OutputFormatting(rawValue: 1 << 1)
     }
 
+    // MARK: - Serialization Backend
+
+    /// The implementation used to write encoded values as TOML text.
+    public enum SerializationBackend: Sendable {
+        /// Write TOML with the encoder's Swift serializer.
+        case swift
+
+        /// Write TOML with toml++'s formatter, into a native byte buffer.
+        ///
+        /// This avoids building the output out of Swift strings,
+        /// which is faster for very large documents.
+        /// Keys are always written in sorted order,
+        /// and output can differ from ``swift`` in small ways,
+        /// such as how fractional seconds and special characters in strings are written.
+        case native
+    }
+
+    // MARK: - Array Encoding Strategy
+
+    /// The strategy used when writing arrays of tables.
+    ///
+    /// The tables of an array of tables are written independently of one another,
+    /// so long arrays can be split into chunks and written on several threads at once.
+    /// The chunks are joined in order, so the output is the same as with ``serial``.
+    public enum ArrayEncodingStrategy: Sendable {
+        /// Write tables one at a time, on the calling thread.
+        ///
+        /// This is the default strategy.
+        case serial
+
+        /// Write arrays of tables with at least `minimumCount` tables in parallel chunks.
+        ///
+        /// Values are still encoded on the calling thread;
+        /// only writing the encoded tables as TOML text is done in parallel.
+        /// Smaller arrays, and arrays nested inside an array being written in parallel,
+        /// are written serially.
+        /// This strategy doesn't apply to the ``SerializationBackend/native`` backend.
+        case concurrent(minimumCount: Int = 1024)
+    }
+
+    // MARK: - Encoding Mode
+
+    /// How the encoder turns encoded values into TOML text.
+    public enum EncodingMode: Sendable {
+        /// Build the whole document as a tree of values, then write it out.
+        case tree
+
+        /// Write each table's key-value pairs as soon as they're encoded.
+        ///
+        /// TOML requires a table's sub-tables and arrays of tables
+        /// to follow all of its key-value pairs,
+        /// so only those sections are held back, as text,
+        /// until the table that contains them is complete.
+        /// Sections are written in the order they're encoded,
+        /// rather than sub-tables before arrays of tables.
+        ///
+        /// Values encoded through unkeyed containers, such as arrays,
+        /// are still built in full before they're written.
+        /// This mode isn't used with ``OutputFormatting/sortedKeys``
+        /// or with the ``SerializationBackend/native`` backend,
+        /// which both need every key of a table before writing it.
+        case singlePass
+    }
+
     // MARK: - Properties
 
     /// The strategy used when encoding `Date` values.
@@ -130,6 +194,15 @@ public final class TOMLEncoder {
     /// The output formatting options.
     public var outputFormatting: OutputFormatting = []
 
+    /// How the encoder turns encoded values into TOML text.
+    public var encodingMode: EncodingMode = .tree
+
+    /// The strategy used when writing arrays of tables.
+    public var arrayEncodingStrategy: ArrayEncodingStrategy = .serial
+
+    /// The implementation used to write encoded values as TOML text.
+    public var serializationBackend: SerializationBackend = .swift
+
     /// A dictionary of contextual information to pass to the encoder.
     public var userInfo: [CodingUserInfoKey: any Sendable] = [:]
 
@@ -146,11 +219,42 @@ public final class TOMLEncoder {
     /// - Returns: UTF-8 encoded data containing the TOML representation.
     /// - Throws: ``TOMLEncodingError`` if encoding fails.
     public func encode<T: Encodable>(_ value: T) throws -> Data {
-        let string = try encodeToString(value)
-        guard let data = string.data(using: .utf8) else {
-            throw TOMLEncodingError.invalidValue("Unable to convert to UTF-8 data", codingPath: [])
+        switch serializationBackend {
+        case .swift:
+            var output = TOMLWriter()
+            try write(value, to: &output)
+            return Data(output.bytes)
+        case .native:
+            return try NativeSerializer.data(for: encodeValue(value))
+        }
+    }
+
+    /// Encodes the given value as TOML, writing it to a sink as it's produced.
+    ///
+    /// Output is written in chunks of a fixed size,
+    /// so the encoded document is never held in memory all at once.
+    /// The sink is flushed after the value has been written.
+    ///
+    /// ```swift
+    /// let sink = TOMLFileSink(fileHandle: .standardOutput)
+    /// try encoder.encode(config, to: sink)
+    /// ```
+    ///
+    /// - Parameters:
+    ///   - value: An `Encodable` value to convert to TOML format.
+    ///   - sink: The destination for the UTF-8 encoded TOML.
+    /// - Throws: ``TOMLEncodingError`` if encoding fails,
+    ///   or any error thrown by the sink.
+    public func encode<T: Encodable>(_ value: T, to sink: some TOMLOutputSink) throws {
+        switch serializationBackend {
+        case .swift:
+            var output = TOMLWriter(sink: sink)
+            try write(value, to: &output)
+            try output.flush()
+        case .native:
+            try NativeSerializer.data(for: encodeValue(value)).withUnsafeBytes { try sink.write($0) }
+            try sink.flush()
         }
-        return data
     }
 
     /// Encodes the given value as a TOML string.
@@ -159,37 +263,122 @@ public final class TOMLEncoder {
     /// - Returns: A string containing the TOML representation.
     /// - Throws: ``TOMLEncodingError`` if encoding fails.
     public func encodeToString<T: Encodable>(_ value: T) throws -> String {
+        switch serializationBackend {
+        case .swift:
+            var output = TOMLWriter()
+            try write(value, to: &output)
+            return String(decoding: output.bytes, as: UTF8.self)
+        case .native:
+            return String(decoding: try NativeSerializer.data(for: encodeValue(value)), as: UTF8.self)
+        }
+    }
+
+    // MARK: - Converting JSON
+
+    /// The kinds of JSON that ``TOMLEncoder/toml(fromJSON:format:)`` reads.
+    public enum JSONFormat: Sendable {
+        /// Ordinary JSON. Objects become tables, and null members are left out.
+        /// TOML arrays can't hold null, so null array elements are rejected.
+        /// Integers that fit in 64 bits stay integers; other numbers become floats.
+        case plain
+
+        /// The tagged JSON used by the [toml-test](https://github.com/toml-lang/toml-test) suite,
+        /// where each value is an object with its TOML type and its value as a string,
+        /// such as `{"type":"date-local","value":"2024-01-15"}`.
+        case tagged
+    }
+
+    /// Converts a JSON object to TOML data.
+    ///
+    /// The JSON is read straight into a toml++ document and written with toml++'s formatter,
+    /// without decoding it with `JSONSerialization` or encoding Swift values,
+    /// so this is the fastest way to convert JSON configuration files to TOML.
+    /// Like the ``SerializationBackend/native`` backend, keys are written in sorted order;
+    /// the encoder's other options don't apply.
+    ///
+    /// - Parameters:
+    ///   - json: UTF-8 encoded JSON, whose top-level value is an object.
+    ///   - format: The kind of JSON to read.
+    /// - Returns: UTF-8 encoded TOML.
+    /// - Throws: ``TOMLEncodingError`` if the JSON is invalid,
+    ///   has a null array element, or holds a tagged value that can't be read.
+    public func toml(fromJSON json: Data, format: JSONFormat = .plain) throws -> Data {
+        try NativeSerializer.data(fromJSON: json, tagged: format == .tagged)
+    }
+
+    // MARK: - Private Serialization
+
+    private var options: EncodingOptions {
+        EncodingOptions(
+            dateEncodingStrategy: dateEncodingStrategy,
+            keyEncodingStrategy: keyEncodingStrategy,
+            outputFormatting: outputFormatting
+        )
+    }
+
+    /// Writes a value with the Swift serializer.
+    private func write<T: Encodable>(_ value: T, to output: inout TOMLWriter) throws {
+        let serializer = TOMLSerializer(
+            sortKeys: outputFormatting.contains(.sortedKeys),
+            arrayEncodingStrategy: arrayEncodingStrategy
+        )
+        if encodingMode == .singlePass, !serializer.sortKeys, !(value is any TOMLEncodable) {
+            let encoder = _TOMLSinglePassEncoder(
+                userInfo: userInfo.reduce(into: [:]) { $0[$1.key] = $1.value },
+                options: options,
+                serializer: serializer,
+                output: output
+            )
+            try value.encode(to: encoder)
+            output = try encoder.finish()
+        } else {
+            try serializer.serializeTable(encodeValue(value), to: &output, path: [])
+        }
+    }
+
+    private func encodeValue<T: Encodable>(_ value: T) throws -> TOMLValue {
         let encoder = _TOMLEncoder(
-            codingPath: [],
+            path: .root,
             userInfo: userInfo.reduce(into: [:]) { $0[$1.key] = $1.value },
-            options: EncodingOptions(
-                dateEncodingStrategy: dateEncodingStrategy,
-                keyEncodingStrategy: keyEncodingStrategy,
-                outputFormatting: outputFormatting
-            )
+            options: options
         )
 
-        try value.encode(to: encoder)
+        if let encodable = value as? any TOMLEncodable {
+            let table = try encodable.tomlTable(options: encoder.options, userInfo: encoder.userInfo, path: .root)
+            encoder.setValue(.table(table))
+        } else {
+            try value.encode(to: encoder)
+        }
 
         guard let value = encoder.value else {
             throw TOMLEncodingError.invalidValue("No value encoded", codingPath: [])
         }
-
-        return serialize(value, sortKeys: outputFormatting.contains(.sortedKeys))
+        return value
     }
+}
 
-    // MARK: - Private Serialization
+// MARK: - Serialization
 
-    private func serialize(_ value: TOMLValue, sortKeys: Bool) -> String {
-        var result = ""
-        serializeTable(value, to: &result, path: [], sortKeys: sortKeys)
-        return result
+/// Writes `TOMLValue` trees as TOML text.
+struct TOMLSerializer {
+    /// Whether table keys are written in sorted order, rather than the order they were encoded.
+    let sortKeys: Bool
+
+    /// Whether long arrays of tables are written in parallel chunks.
+    var arrayEncodingStrategy: TOMLEncoder.ArrayEncodingStrategy = .serial
+
+    /// A serializer with the same options that writes arrays of tables serially,
+    /// for use inside a chunk being written in parallel.
+    var serial: TOMLSerializer {
+        TOMLSerializer(sortKeys: sortKeys, arrayEncodingStrategy: .serial)
     }
 
-    private func serializeTable(_ value: TOMLValue, to output: inout String, path: [String], sortKeys: Bool) {
+    /// Writes the key-value pairs of a table,
+    /// followed by its sub-tables and arrays of tables.
+    func serializeTable(_ value: TOMLValue, to output: inout TOMLWriter, path: [String]) throws {
         guard case .table(let dict) = value else { return }
 
-        let keys = sortKeys ? dict.keys.sorted() : Array(dict.keys)
+        let keys = sortKeys ? dict.keys.sorted() : dict.keys
 
         var simpleKeys: [String] = []
         var tableKeys: [String] = []
@@ -200,7 +389,7 @@ public final class TOMLEncoder {
             switch val {
             case .table:
                 tableKeys.append(key)
-            case .array(let arr) where !arr.isEmpty && arr.allSatisfy({ $0.isTable }):
+            case _ where val.isArrayOfTables:
                 arrayOfTablesKeys.append(key)
             default:
                 simpleKeys.append(key)
@@ -209,135 +398,411 @@ public final class TOMLEncoder {
 
         for key in simpleKeys {
             guard let val = dict[key] else { continue }
-            output += "\(escapeKey(key)) = \(serializeValue(val, sortKeys: sortKeys))\n"
+            try serializeKeyValue(key, val, to: &output)
         }
 
-        for key in tableKeys {
+        for key in tableKeys + arrayOfTablesKeys {
             guard let val = dict[key] else { continue }
-            let newPath = path + [key]
-            output += "\n[\(newPath.map(escapeKey).joined(separator: "."))]\n"
-            serializeTable(val, to: &output, path: newPath, sortKeys: sortKeys)
+            try serializeSection(val, to: &output, path: path + [key])
         }
+    }
 
-        for key in arrayOfTablesKeys {
-            guard case .array(let arr) = dict[key] else { continue }
-            let newPath = path + [key]
+    /// Writes a sub-table, with its header, or each table of an array of tables.
+    func serializeSection(_ value: TOMLValue, to output: inout TOMLWriter, path: [String]) throws {
+        let name = path.map(escapeKey).joined(separator: ".")
+        if case .array(let arr) = value {
+            let header = "\n[[\(name)]]\n"
+            if case .concurrent(let minimumCount) = arrayEncodingStrategy, arr.count >= minimumCount {
+                try serializeConcurrently(arr, header: header, to: &output, path: path)
+                return
+            }
             for item in arr {
-                output += "\n[[\(newPath.map(escapeKey).joined(separator: "."))]]"
-                output += "\n"
-                serializeTable(item, to: &output, path: newPath, sortKeys: sortKeys)
+                try output.write(header)
+                try serializeTable(item, to: &output, path: path)
+            }
+        } else {
+            try output.write("\n[\(name)]\n")
+            try serializeTable(value, to: &output, path: path)
+        }
+    }
+
+    /// Writes the tables of an array of tables in chunks, one chunk per work item,
+    /// then writes the chunks to the output in order.
+    ///
+    /// Each chunk is written to its own buffer without a sink.
+    /// If writing a chunk fails, such as on a date TOML can't represent,
+    /// the first failing chunk's error is thrown and nothing more is written.
+    private func serializeConcurrently(
+        _ tables: [TOMLValue],
+        header: String,
+        to output: inout TOMLWriter,
+        path: [String]
+    ) throws {
+        let count = tables.count
+        let chunkSize = Swift.max(1, count / (ProcessInfo.processInfo.activeProcessorCount * 4))
+        let chunkCount = (count + chunkSize - 1) / chunkSize
+        let serializer = self.serial
+
+        let chunks = UnsafeMutableBufferPointer<Result<TOMLWriter, any Error>>.allocate(capacity: chunkCount)
+        defer {
+            _ = chunks.deinitialize()
+            chunks.deallocate()
+        }
+
+        DispatchQueue.concurrentPerform(iterations: chunkCount) { chunk in
+            let start = chunk * chunkSize
+            let end = Swift.min(start + chunkSize, count)
+            let result = Result { () throws -> TOMLWriter in
+                var writer = TOMLWriter()
+                for item in tables[start ..< end] {
+                    try writer.write(header)
+                    try serializer.serializeTable(item, to: &writer, path: path)
+                }
+                return writer
             }
+            (chunks.baseAddress! + chunk).initialize(to: result)
         }
+
+        for chunk in chunks {
+            try output.write(chunk.get())
+        }
+    }
+
+    /// Writes a single `key = value` line.
+    func serializeKeyValue(_ key: String, _ value: TOMLValue, to output: inout TOMLWriter) throws {
+        try writeKey(key, to: &output)
+        try output.write(" = ")
+        try serializeValue(value, to: &output)
+        try output.write("\n")
     }
 
-    private func serializeValue(_ value: TOMLValue, sortKeys: Bool) -> String {
+    func serializeValue(_ value: TOMLValue, to output: inout TOMLWriter) throws {
         switch value {
         case .string(let s):
-            return "\"\(escapeString(s))\""
+            try writeString(s, to: &output)
         case .integer(let i):
-            return String(i)
+            try output.append { TOMLSerializer.appendDigits(i, width: 1, to: &$0) }
         case .float(let f):
-            if f.isNaN {
-                return "nan"
-            } else if f.isInfinite {
-                return f > 0 ? "inf" : "-inf"
-            }
-            return String(f)
+            try writeFloat(f, to: &output)
         case .boolean(let b):
-            return b ? "true" : "false"
+            try output.write(b ? "true" : "false")
         case .offsetDateTime(let date):
-            return formatOffsetDateTime(date)
+            try output.append { try TOMLSerializer.appendOffsetDateTime(date, to: &$0) }
         case .localDateTime(let dt):
-            return formatLocalDateTime(dt)
+            try output.append { bytes in
+                TOMLSerializer.appendDate(year: dt.year, month: dt.month, day: dt.day, to: &bytes)
+                bytes.append(UInt8(ascii: "T"))
+                TOMLSerializer.appendTime(
+                    hour: dt.hour,
+                    minute: dt.minute,
+                    second: dt.second,
+                    nanosecond: dt.nanosecond,
+                    to: &bytes
+                )
+            }
         case .localDate(let d):
-            return formatLocalDate(d)
+            try output.append { TOMLSerializer.appendDate(year: d.year, month: d.month, day: d.day, to: &$0) }
         case .localTime(let t):
-            return formatLocalTime(t)
+            try output.append { bytes in
+                TOMLSerializer.appendTime(
+                    hour: t.hour,
+                    minute: t.minute,
+                    second: t.second,
+                    nanosecond: t.nanosecond,
+                    to: &bytes
+                )
+            }
         case .array(let arr):
-            let items = arr.map { serializeValue($0, sortKeys: sortKeys) }
-            return "[\(items.joined(separator: ", "))]"
+            try output.write("[")
+            for (i, item) in arr.enumerated() {
+                if i > 0 {
+                    try output.write(", ")
+                }
+                try serializeValue(item, to: &output)
+            }
+            try output.write("]")
         case .table(let dict):
-            let keys = sortKeys ? dict.keys.sorted() : Array(dict.keys)
-            let items = keys.compactMap { key -> String? in
-                guard let val = dict[key] else { return nil }
-                return "\(escapeKey(key)) = \(serializeValue(val, sortKeys: sortKeys))"
+            let keys = sortKeys ? dict.keys.sorted() : dict.keys
+            try output.write("{ ")
+            var first = true
+            for key in keys {
+                guard let val = dict[key] else { continue }
+                if !first {
+                    try output.write(", ")
+                }
+                first = false
+                try writeKey(key, to: &output)
+                try output.write(" = ")
+                try serializeValue(val, to: &output)
             }
-            return "{ \(items.joined(separator: ", ")) }"
+            try output.write(" }")
         }
     }
 
-    private func escapeKey(_ key: String) -> String {
-        let bareKeyPattern = #"^[A-Za-z0-9_-]+$"#
-        if key.range(of: bareKeyPattern, options: .regularExpression) != nil {
-            return key
+    /// Writes a key, quoted and escaped unless it's a bare key.
+    func writeKey(_ key: String, to output: inout TOMLWriter) throws {
+        var key = key
+        try key.withUTF8 { utf8 in
+            try output.append { TOMLSerializer.appendKey(utf8, to: &$0) }
         }
-        return "\"\(escapeString(key))\""
     }
 
-    private func escapeString(_ s: String) -> String {
-        var result = ""
-        // Iterate over Unicode scalars to preserve individual CR and LF characters
-        // (Swift treats CR+LF as a single Character grapheme cluster)
-        for scalar in s.unicodeScalars {
-            switch scalar {
-            case "\"": result += "\\\""
-            case "\\": result += "\\\\"
-            case "\n": result += "\\n"
-            case "\r": result += "\\r"
-            case "\t": result += "\\t"
-            case "\u{08}": result += "\\b"  // backspace
-            case "\u{0C}": result += "\\f"  // formfeed
-            case "\u{7F}": result += "\\u007F"  // DEL
-            default:
-                if scalar.isASCII && scalar.value < 32 {
-                    result += String(format: "\\u%04X", scalar.value)
-                } else {
-                    result.append(Character(scalar))
-                }
+    /// Writes a string as a quoted basic string.
+    func writeString(_ s: String, to output: inout TOMLWriter) throws {
+        var s = s
+        try s.withUTF8 { utf8 in
+            try output.append { bytes in
+                bytes.append(UInt8(ascii: "\""))
+                TOMLSerializer.appendEscaped(utf8, to: &bytes)
+                bytes.append(UInt8(ascii: "\""))
             }
         }
-        return result
     }
 
-    private func formatOffsetDateTime(_ date: Date) -> String {
-        let formatter = ISO8601DateFormatter()
-        formatter.formatOptions = [.withInternetDateTime, .withFractionalSeconds]
-        return formatter.string(from: date)
+    func escapeKey(_ key: String) -> String {
+        var key = key
+        let quoted: [UInt8]? = key.withUTF8 { utf8 in
+            guard !TOMLSerializer.isBareKey(utf8) else { return nil }
+            var bytes: [UInt8] = []
+            TOMLSerializer.appendKey(utf8, to: &bytes)
+            return bytes
+        }
+        return quoted.map { String(decoding: $0, as: UTF8.self) } ?? key
     }
 
-    private func formatLocalDateTime(_ dt: LocalDateTime) -> String {
-        var result = String(
-            format: "%04d-%02d-%02dT%02d:%02d:%02d",
-            dt.year,
-            dt.month,
-            dt.day,
-            dt.hour,
-            dt.minute,
-            dt.second
-        )
-        if dt.nanosecond > 0 {
-            result += formatFractionalSeconds(dt.nanosecond)
+    // MARK: Escaping
+
+    /// Whether each byte can appear in a bare key: `A-Z`, `a-z`, `0-9`, `_`, and `-`.
+    private static let bareKeyBytes: [Bool] = (0 ... 255).map { byte in
+        switch UInt8(byte) {
+        case 0x30 ... 0x39, 0x41 ... 0x5A, 0x61 ... 0x7A, 0x2D, 0x5F:
+            return true
+        default:
+            return false
+        }
+    }
+
+    /// The escape for each byte of a basic string:
+    /// the character that follows the backslash,
+    /// `u` for a `\uXXXX` escape, or `0` if the byte is written as is.
+    ///
+    /// Bytes of multi-byte UTF-8 sequences are always written as is.
+    private static let escapeBytes: [UInt8] = (0 ... 255).map { byte in
+        switch UInt8(byte) {
+        case 0x08: return UInt8(ascii: "b")
+        case 0x09: return UInt8(ascii: "t")
+        case 0x0A: return UInt8(ascii: "n")
+        case 0x0C: return UInt8(ascii: "f")
+        case 0x0D: return UInt8(ascii: "r")
+        case 0x22: return UInt8(ascii: "\"")
+        case 0x5C: return UInt8(ascii: "\\")
+        case 0x00 ..< 0x20, 0x7F: return UInt8(ascii: "u")
+        default: return 0
         }
-        return result
     }
 
-    private func formatLocalDate(_ d: LocalDate) -> String {
-        String(format: "%04d-%02d-%02d", d.year, d.month, d.day)
+    private static let hexDigits = Array("0123456789ABCDEF".utf8)
+
+    static func isBareKey(_ utf8: UnsafeBufferPointer<UInt8>) -> Bool {
+        guard !utf8.isEmpty else { return false }
+        return bareKeyBytes.withUnsafeBufferPointer { table in
+            utf8.allSatisfy { table[Int($0)] }
+        }
     }
 
-    private func formatLocalTime(_ t: LocalTime) -> String {
-        var result = String(format: "%02d:%02d:%02d", t.hour, t.minute, t.second)
-        if t.nanosecond > 0 {
-            result += formatFractionalSeconds(t.nanosecond)
+    static func appendKey(_ utf8: UnsafeBufferPointer<UInt8>, to bytes: inout [UInt8]) {
+        if isBareKey(utf8) {
+            bytes.append(contentsOf: utf8)
+        } else {
+            bytes.append(UInt8(ascii: "\""))
+            appendEscaped(utf8, to: &bytes)
+            bytes.append(UInt8(ascii: "\""))
+        }
+    }
+
+    /// Appends the contents of a basic string, escaping the bytes that need it.
+    ///
+    /// Runs of bytes that don't need escaping are found eight bytes at a time
+    /// and copied in bulk.
+    static func appendEscaped(_ utf8: UnsafeBufferPointer<UInt8>, to bytes: inout [UInt8]) {
+        escapeBytes.withUnsafeBufferPointer { table in
+            var start = 0
+            while start < utf8.count {
+                let end = firstEscape(in: utf8, from: start, table: table)
+                bytes.append(contentsOf: UnsafeBufferPointer(rebasing: utf8[start ..< end]))
+                guard end < utf8.count else { break }
+
+                let byte = utf8[end]
+                let escape = table[Int(byte)]
+                bytes.append(UInt8(ascii: "\\"))
+                bytes.append(escape)
+                if escape == UInt8(ascii: "u") {
+                    bytes.append(UInt8(ascii: "0"))
+                    bytes.append(UInt8(ascii: "0"))
+                    bytes.append(hexDigits[Int(byte >> 4)])
+                    bytes.append(hexDigits[Int(byte & 0x0F)])
+                }
+                start = end + 1
+            }
         }
-        return result
     }
 
-    private func formatFractionalSeconds(_ nanosecond: Int) -> String {
-        // Convert nanoseconds to fractional string, trimming trailing zeros
-        let fractional = String(format: "%09d", nanosecond)
-        let trimmed = fractional.replacingOccurrences(of: "0+$", with: "", options: .regularExpression)
-        return ".\(trimmed)"
+    /// Returns the index of the first byte at or after `start` that needs escaping,
+    /// or the end of the buffer if there isn't one.
+    private static func firstEscape(
+        in utf8: UnsafeBufferPointer<UInt8>,
+        from start: Int,
+        table: UnsafeBufferPointer<UInt8>
+    ) -> Int {
+        guard let base = utf8.baseAddress else { return start }
+        var index = start
+        while index + 8 <= utf8.count {
+            let word = UnsafeRawPointer(base + index).loadUnaligned(as: UInt64.self)
+            if mayNeedEscape(word) {
+                break
+            }
+            index += 8
+        }
+        while index < utf8.count, table[Int(utf8[index])] == 0 {
+            index += 1
+        }
+        return index
+    }
+
+    /// Whether any byte of a word is a control character, `"`, `\`, or DEL.
+    private static func mayNeedEscape(_ word: UInt64) -> Bool {
+        let ones: UInt64 = 0x0101_0101_0101_0101
+        let highBits: UInt64 = 0x8080_8080_8080_8080
+
+        // A byte is below 0x20 if subtracting 0x20 borrows into its high bit,
+        // and a byte equals c if it's zero after an XOR with c.
+        func zeroBytes(_ x: UInt64) -> UInt64 { (x &- ones) & ~x }
+
+        let bits = ((word &- ones &* 0x20) & ~word)
+            | zeroBytes(word ^ (ones &* 0x22))
+            | zeroBytes(word ^ (ones &* 0x5C))
+            | zeroBytes(word ^ (ones &* 0x7F))
+        return bits & highBits != 0
+    }
+
+    // MARK: Numbers and Dates
+
+    /// Writes a float the way `Double.description` does,
+    /// with the shortest digits that round-trip.
+    private func writeFloat(_ f: Double, to output: inout TOMLWriter) throws {
+        if f.isNaN {
+            try output.write("nan")
+        } else if f.isInfinite {
+            try output.write(f > 0 ? "inf" : "-inf")
+        } else if f == f.rounded(.towardZero), abs(f) < 1e15, f != 0 || f.sign == .plus {
+            // Integral values are written as digits, without formatting a string.
+            try output.append { bytes in
+                TOMLSerializer.appendDigits(Int64(f), width: 1, to: &bytes)
+                bytes.append(UInt8(ascii: "."))
+                bytes.append(UInt8(ascii: "0"))
+            }
+        } else {
+            // Most descriptions fit in a small string, which isn't allocated on the heap.
+            try output.write(f.description)
+        }
+    }
+
+    /// Appends an integer in decimal, padded with leading zeros to at least `width` characters.
+    static func appendDigits(_ value: Int64, width: Int, to bytes: inout [UInt8]) {
+        var magnitude = value.magnitude
+        var width = width
+        if value < 0 {
+            bytes.append(UInt8(ascii: "-"))
+            width -= 1
+        }
+
+        var count = 1
+        var rest = magnitude / 10
+        while rest > 0 {
+            count += 1
+            rest /= 10
+        }
+
+        bytes.append(contentsOf: repeatElement(UInt8(ascii: "0"), count: max(width, count)))
+        var index = bytes.count
+        repeat {
+            index -= 1
+            bytes[index] = UInt8(ascii: "0") + UInt8(magnitude % 10)
+            magnitude /= 10
+        } while magnitude > 0
+    }
+
+    /// The seconds since 1970 of the first and last instants TOML can write, in years 0000 through 9999.
+    static let dateSecondsRange: ClosedRange<Double> = -62_167_219_200 ... 253_402_300_799
+
+    /// Checks that `seconds`, the whole seconds since 1970 that `date` is written as,
+    /// fall in years 0000 through 9999, which rules out NaN and infinite dates too.
+    ///
+    /// - Throws: ``TOMLEncodingError/invalidValue(_:codingPath:)`` if they don't.
+    static func checkDateRange(_ seconds: Double, of date: Date, codingPath: [any CodingKey]) throws {
+        guard dateSecondsRange.contains(seconds) else {
+            throw TOMLEncodingError.invalidValue(
+                "Date \(date.timeIntervalSince1970) is outside the years 0000 through 9999",
+                codingPath: codingPath
+            )
+        }
+    }
+
+    /// Appends a UTC date and time with millisecond precision, like `1979-05-27T07:32:00.000Z`.
+    ///
+    /// - Throws: ``TOMLEncodingError/invalidValue(_:codingPath:)``
+    ///   if the date isn't in years 0000 through 9999.
+    static func appendOffsetDateTime(
+        _ date: Date,
+        codingPath: [any CodingKey] = [],
+        to bytes: inout [UInt8]
+    ) throws {
+        let milliseconds = (date.timeIntervalSince1970 * 1000).rounded()
+        try checkDateRange((milliseconds / 1000).rounded(.down), of: date, codingPath: codingPath)
+
+        let total = Int64(milliseconds)
+        var seconds = total / 1000
+        var millisecond = total % 1000
+        if millisecond < 0 {
+            seconds -= 1
+            millisecond += 1000
+        }
+
+        let dt = LocalDateTime(secondsSince1970: seconds)
+        appendDate(year: dt.year, month: dt.month, day: dt.day, to: &bytes)
+        bytes.append(UInt8(ascii: "T"))
+        appendTime(hour: dt.hour, minute: dt.minute, second: dt.second, nanosecond: 0, to: &bytes)
+        bytes.append(UInt8(ascii: "."))
+        appendDigits(millisecond, width: 3, to: &bytes)
+        bytes.append(UInt8(ascii: "Z"))
+    }
+
+    static func appendDate(year: Int, month: Int, day: Int, to bytes: inout [UInt8]) {
+        appendDigits(Int64(year), width: 4, to: &bytes)
+        bytes.append(UInt8(ascii: "-"))
+        appendDigits(Int64(month), width: 2, to: &bytes)
+        bytes.append(UInt8(ascii: "-"))
+        appendDigits(Int64(day), width: 2, to: &bytes)
+    }
+
+    /// Appends a time, with fractional seconds only if `nanosecond` isn't zero,
+    /// trimmed of trailing zeros.
+    static func appendTime(hour: Int, minute: Int, second: Int, nanosecond: Int, to bytes: inout [UInt8]) {
+        appendDigits(Int64(hour), width: 2, to: &bytes)
+        bytes.append(UInt8(ascii: ":"))
+        appendDigits(Int64(minute), width: 2, to: &bytes)
+        bytes.append(UInt8(ascii: ":"))
+        appendDigits(Int64(second), width: 2, to: &bytes)
+
+        guard nanosecond > 0 else { return }
+        var fraction = nanosecond
+        var digits = 9
+        while fraction % 10 == 0 {
+            fraction /= 10
+            digits -= 1
+        }
+        bytes.append(UInt8(ascii: "."))
+        appendDigits(Int64(fraction), width: digits, to: &bytes)
     }
 }
 
@@ -374,20 +839,28 @@ struct EncodingOptions {
     let dateEncodingStrategy: TOMLEncoder.DateEncodingStrategy
     let keyEncodingStrategy: TOMLEncoder.KeyEncodingStrategy
     let outputFormatting: TOMLEncoder.OutputFormatting
+
+    /// The options of a newly created ``TOMLEncoder``.
+    static let `default` = EncodingOptions(
+        dateEncodingStrategy: .iso8601,
+        keyEncodingStrategy: .useDefaultKeys,
+        outputFormatting: []
+    )
 }
 
 // MARK: - Internal Encoder
 
 final class _TOMLEncoder: Encoder {
-    var codingPath: [any CodingKey]
+    let path: CodingPath
+    var codingPath: [any CodingKey] { path.keys }
     var userInfo: [CodingUserInfoKey: Any]
     let options: EncodingOptions
 
     var value: TOMLValue?
     private var storage: TOMLEncodingStorage
 
-    init(codingPath: [any CodingKey], userInfo: [CodingUserInfoKey: Any], options: EncodingOptions) {
-        self.codingPath = codingPath
+    init(path: CodingPath, userInfo: [CodingUserInfoKey: Any], options: EncodingOptions) {
+        self.path = path
         self.userInfo = userInfo
         self.options = options
         self.storage = TOMLEncodingStorage()
@@ -396,7 +869,7 @@ final class _TOMLEncoder: Encoder {
     func container<Key: CodingKey>(keyedBy type: Key.Type) -> KeyedEncodingContainer<Key> {
         let container = TOMLKeyedEncodingContainer<Key>(
             encoder: self,
-            codingPath: codingPath
+            path: path
         )
         return KeyedEncodingContainer(container)
     }
@@ -404,14 +877,14 @@ final class _TOMLEncoder: Encoder {
     func unkeyedContainer() -> any UnkeyedEncodingContainer {
         TOMLUnkeyedEncodingContainer(
             encoder: self,
-            codingPath: codingPath
+            path: path
         )
     }
 
     func singleValueContainer() -> any SingleValueEncodingContainer {
         TOMLSingleValueEncodingContainer(
             encoder: self,
-            codingPath: codingPath
+            path: path
         )
     }
 
@@ -422,7 +895,7 @@ final class _TOMLEncoder: Encoder {
 
 // MARK: - Boxing Helpers
 
-private extension _TOMLEncoder {
+extension _TOMLEncoder {
     func box(_ value: Bool) -> TOMLValue { .boolean(value) }
     func box(_ value: Int) -> TOMLValue { .integer(Int64(value)) }
     func box(_ value: Int8) -> TOMLValue { .integer(Int64(value)) }
@@ -438,48 +911,24 @@ private extension _TOMLEncoder {
     func box(_ value: Double) -> TOMLValue { .float(value) }
     func box(_ value: String) -> TOMLValue { .string(value) }
 
-    func box(_ date: Date) -> TOMLValue {
+    /// Boxes a date encoded at `path`.
+    ///
+    /// - Throws: ``TOMLEncodingError/invalidValue(_:codingPath:)``
+    ///   if the date is written as a date-time that isn't in years 0000 through 9999.
+    func box(_ date: Date, at path: CodingPath) throws -> TOMLValue {
         switch options.dateEncodingStrategy {
         case .iso8601:
+            let milliseconds = (date.timeIntervalSince1970 * 1000).rounded()
+            try TOMLSerializer.checkDateRange((milliseconds / 1000).rounded(.down), of: date, codingPath: path.keys)
             return .offsetDateTime(date)
         case .localDateTime:
-            let components = Calendar.current.dateComponents(
-                [.year, .month, .day, .hour, .minute, .second, .nanosecond],
-                from: date
-            )
-            return .localDateTime(
-                LocalDateTime(
-                    year: components.year ?? 0,
-                    month: components.month ?? 0,
-                    day: components.day ?? 0,
-                    hour: components.hour ?? 0,
-                    minute: components.minute ?? 0,
-                    second: components.second ?? 0,
-                    nanosecond: components.nanosecond ?? 0
-                )
-            )
+            return .localDateTime(try localDateTime(of: date, at: path))
         case .localDate:
-            let components = Calendar.current.dateComponents([.year, .month, .day], from: date)
-            return .localDate(
-                LocalDate(
-                    year: components.year ?? 0,
-                    month: components.month ?? 0,
-                    day: components.day ?? 0
-                )
-            )
+            let dt = try localDateTime(of: date, at: path)
+            return .localDate(LocalDate(year: dt.year, month: dt.month, day: dt.day))
         case .localTime:
-            let components = Calendar.current.dateComponents(
-                [.hour, .minute, .second, .nanosecond],
-                from: date
-            )
-            return .localTime(
-                LocalTime(
-                    hour: components.hour ?? 0,
-                    minute: components.minute ?? 0,
-                    second: components.second ?? 0,
-                    nanosecond: components.nanosecond ?? 0
-                )
-            )
+            let dt = try localDateTime(of: date, at: path)
+            return .localTime(LocalTime(hour: dt.hour, minute: dt.minute, second: dt.second, nanosecond: dt.nanosecond))
         case .secondsSince1970:
             return .float(date.timeIntervalSince1970)
         case .millisecondsSince1970:
@@ -487,9 +936,28 @@ private extension _TOMLEncoder {
         }
     }
 
-    func box<T: Encodable>(_ value: T) throws -> TOMLValue {
+    /// Returns the date and time of a date in the current time zone, in the Gregorian calendar.
+    ///
+    /// - Throws: ``TOMLEncodingError/invalidValue(_:codingPath:)``
+    ///   if the local date isn't in years 0000 through 9999.
+    private func localDateTime(of date: Date, at path: CodingPath) throws -> LocalDateTime {
+        let interval = date.timeIntervalSince1970 + Double(TimeZone.current.secondsFromGMT(for: date))
+
+        var seconds = interval.rounded(.down)
+        try TOMLSerializer.checkDateRange(seconds, of: date, codingPath: path.keys)
+        var nanosecond = Int(((interval - seconds) * 1e9).rounded())
+        if nanosecond >= 1_000_000_000 {
+            seconds += 1
+            nanosecond -= 1_000_000_000
+            try TOMLSerializer.checkDateRange(seconds, of: date, codingPath: path.keys)
+        }
+        return LocalDateTime(secondsSince1970: Int64(seconds), nanosecond: nanosecond)
+    }
+
+    /// Boxes a value encoded at `valuePath`, which errors from its own encoding report.
+    func box<T: Encodable>(_ value: T, at valuePath: CodingPath) throws -> TOMLValue {
         if let date = value as? Date {
-            return box(date)
+            return try box(date, at: valuePath)
         }
         if let localDateTime = value as? LocalDateTime {
             return .localDateTime(localDateTime)
@@ -500,15 +968,18 @@ private extension _TOMLEncoder {
         if let localTime = value as? LocalTime {
             return .localTime(localTime)
         }
+        if let encodable = value as? any TOMLEncodable {
+            return .table(try encodable.tomlTable(options: options, userInfo: userInfo, path: valuePath))
+        }
 
-        let encoder = _TOMLEncoder(codingPath: codingPath, userInfo: userInfo, options: options)
+        let encoder = _TOMLEncoder(path: valuePath, userInfo: userInfo, options: options)
         try value.encode(to: encoder)
 
         if let v = encoder.value {
             return v
         }
 
-        throw TOMLEncodingError.invalidValue("Unable to encode \(type(of: value))", codingPath: codingPath)
+        throw TOMLEncodingError.invalidValue("Unable to encode \(type(of: value))", codingPath: valuePath.keys)
     }
 
     func convertKey(_ key: any CodingKey) -> String {
@@ -516,7 +987,7 @@ private extension _TOMLEncoder {
         case .useDefaultKeys:
             return key.stringValue
         case .convertToSnakeCase:
-            return key.stringValue.convertToSnakeCase()
+            return toSnakeCaseKeys.convert(key)
         }
     }
 }
@@ -530,14 +1001,15 @@ private final class TOMLEncodingStorage {
 // MARK: - Keyed Encoding Container
 
 private struct TOMLKeyedEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProtocol {
-    var codingPath: [any CodingKey]
+    let path: CodingPath
+    var codingPath: [any CodingKey] { path.keys }
     let encoder: _TOMLEncoder
 
-    private var storage: [String: TOMLValue] = [:]
+    private var storage: TOMLValue.Table = [:]
 
-    init(encoder: _TOMLEncoder, codingPath: [any CodingKey]) {
+    init(encoder: _TOMLEncoder, path: CodingPath) {
         self.encoder = encoder
-        self.codingPath = codingPath
+        self.path = path
         // Initialize with empty table so empty containers are valid
         encoder.setValue(.table([:]))
     }
@@ -608,7 +1080,7 @@ private struct TOMLKeyedEncodingContainer<Key: CodingKey>: KeyedEncodingContaine
     }
 
     mutating func encode<T: Encodable>(_ value: T, forKey key: Key) throws {
-        let boxed = try encoder.box(value)
+        let boxed = try encoder.box(value, at: path.appending(key))
         set(boxed, forKey: key)
     }
 
@@ -617,7 +1089,7 @@ private struct TOMLKeyedEncodingContainer<Key: CodingKey>: KeyedEncodingContaine
         forKey key: Key
     ) -> KeyedEncodingContainer<NestedKey> {
         let nestedEncoder = _TOMLEncoder(
-            codingPath: codingPath + [key],
+            path: path.appending(key),
             userInfo: encoder.userInfo,
             options: encoder.options
         )
@@ -626,7 +1098,7 @@ private struct TOMLKeyedEncodingContainer<Key: CodingKey>: KeyedEncodingContaine
 
     mutating func nestedUnkeyedContainer(forKey key: Key) -> any UnkeyedEncodingContainer {
         let nestedEncoder = _TOMLEncoder(
-            codingPath: codingPath + [key],
+            path: path.appending(key),
             userInfo: encoder.userInfo,
             options: encoder.options
         )
@@ -634,27 +1106,28 @@ private struct TOMLKeyedEncodingContainer<Key: CodingKey>: KeyedEncodingContaine
     }
 
     mutating func superEncoder() -> any Encoder {
-        _TOMLEncoder(codingPath: codingPath, userInfo: encoder.userInfo, options: encoder.options)
+        _TOMLEncoder(path: path, userInfo: encoder.userInfo, options: encoder.options)
     }
 
     mutating func superEncoder(forKey key: Key) -> any Encoder {
-        _TOMLEncoder(codingPath: codingPath + [key], userInfo: encoder.userInfo, options: encoder.options)
+        _TOMLEncoder(path: path.appending(key), userInfo: encoder.userInfo, options: encoder.options)
     }
 }
 
 // MARK: - Unkeyed Encoding Container
 
 private struct TOMLUnkeyedEncodingContainer: UnkeyedEncodingContainer {
-    var codingPath: [any CodingKey]
+    let path: CodingPath
+    var codingPath: [any CodingKey] { path.keys }
     let encoder: _TOMLEncoder
 
     private var storage: [TOMLValue] = []
 
     var count: Int { storage.count }
 
-    init(encoder: _TOMLEncoder, codingPath: [any CodingKey]) {
+    init(encoder: _TOMLEncoder, path: CodingPath) {
         self.encoder = encoder
-        self.codingPath = codingPath
+        self.path = path
         // Initialize with empty array so empty containers are valid
         encoder.setValue(.array([]))
     }
@@ -724,7 +1197,7 @@ private struct TOMLUnkeyedEncodingContainer: UnkeyedEncodingContainer {
     }
 
     mutating func encode<T: Encodable>(_ value: T) throws {
-        let boxed = try encoder.box(value)
+        let boxed = try encoder.box(value, at: path.appending(index: count))
         append(boxed)
     }
 
@@ -732,7 +1205,7 @@ private struct TOMLUnkeyedEncodingContainer: UnkeyedEncodingContainer {
         keyedBy keyType: NestedKey.Type
     ) -> KeyedEncodingContainer<NestedKey> {
         let nestedEncoder = _TOMLEncoder(
-            codingPath: codingPath + [TOMLCodingKey(index: count)],
+            path: path.appending(index: count),
             userInfo: encoder.userInfo,
             options: encoder.options
         )
@@ -741,7 +1214,7 @@ private struct TOMLUnkeyedEncodingContainer: UnkeyedEncodingContainer {
 
     mutating func nestedUnkeyedContainer() -> any UnkeyedEncodingContainer {
         let nestedEncoder = _TOMLEncoder(
-            codingPath: codingPath + [TOMLCodingKey(index: count)],
+            path: path.appending(index: count),
             userInfo: encoder.userInfo,
             options: encoder.options
         )
@@ -750,7 +1223,7 @@ private struct TOMLUnkeyedEncodingContainer: UnkeyedEncodingContainer {
 
     mutating func superEncoder() -> any Encoder {
         _TOMLEncoder(
-            codingPath: codingPath + [TOMLCodingKey(index: count)],
+            path: path.appending(index: count),
             userInfo: encoder.userInfo,
             options: encoder.options
         )
@@ -760,12 +1233,13 @@ private struct TOMLUnkeyedEncodingContainer: UnkeyedEncodingContainer {
 // MARK: - Single Value Encoding Container
 
 private struct TOMLSingleValueEncodingContainer: SingleValueEncodingContainer {
-    var codingPath: [any CodingKey]
+    let path: CodingPath
+    var codingPath: [any CodingKey] { path.keys }
     let encoder: _TOMLEncoder
 
-    init(encoder: _TOMLEncoder, codingPath: [any CodingKey]) {
+    init(encoder: _TOMLEncoder, path: CodingPath) {
         self.encoder = encoder
-        self.codingPath = codingPath
+        self.path = path
     }
 
     mutating func encodeNil() throws {
@@ -828,13 +1302,15 @@ private struct TOMLSingleValueEncodingContainer: SingleValueEncodingContainer {
     }
 
     mutating func encode<T: Encodable>(_ value: T) throws {
-        let boxed = try encoder.box(value)
+        let boxed = try encoder.box(value, at: path)
         encoder.setValue(boxed)
     }
 }
 
 // MARK: - Private Extensions
 
+let toSnakeCaseKeys = KeyConversionCache { $0.convertToSnakeCase() }
+
 private extension String {
     func convertToSnakeCase() -> String {
         var result = ""
@@ -852,9 +1328,15 @@ private extension String {
     }
 }
 
-private extension TOMLValue {
+extension TOMLValue {
     var isTable: Bool {
         if case .table = self { return true }
         return false
     }
+
+    /// Whether the value is written as an array of tables, with a `[[header]]` for each element.
+    var isArrayOfTables: Bool {
+        if case .array(let arr) = self { return !arr.isEmpty && arr.allSatisfy(\.isTable) }
+        return false
+    }
 }
@@ -119,3 +119,39 @@ public struct LocalTime: Sendable, Equatable, Hashable, Codable {
         self.nanosecond = nanosecond
     }
 }
+
+// MARK: - Civil Calendar Arithmetic
+
+extension LocalDateTime {
+    /// Creates the date and time, in the proleptic Gregorian calendar,
+    /// that is a number of seconds after 1970-01-01T00:00:00.
+    ///
+    /// The date is computed arithmetically,
+    /// without going through `Calendar` or `DateComponents`.
+    init(secondsSince1970 seconds: Int64, nanosecond: Int = 0) {
+        let (days, secondOfDay) = LocalDateTime.floorDivide(seconds, 86_400)
+
+        // Howard Hinnant's civil_from_days, with eras of 400 years starting in March.
+        let (era, dayOfEra) = LocalDateTime.floorDivide(days + 719_468, 146_097)
+        let yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146_096) / 365
+        let dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100)
+        let shiftedMonth = (5 * dayOfYear + 2) / 153
+        let month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9
+        let year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0)
+
+        self.init(
+            year: Int(year),
+            month: Int(month),
+            day: Int(dayOfYear - (153 * shiftedMonth + 2) / 5 + 1),
+            hour: Int(secondOfDay / 3600),
+            minute: Int(secondOfDay % 3600 / 60),
+            second: Int(secondOfDay % 60),
+            nanosecond: nanosecond
+        )
+    }
+
+    private static func floorDivide(_ value: Int64, _ divisor: Int64) -> (quotient: Int64, remainder: Int64) {
+        let quotient = value >= 0 ? value / divisor : (value - divisor + 1) / divisor
+        return (quotient, value - quotient * divisor)
+    }
+}
@@ -0,0 +1,141 @@
+import CTomlPlusPlus
+import Foundation
+
+/// Writes encoded values as TOML with toml++'s formatter.
+///
+/// The value is rebuilt as a toml++ document through the `ctoml_builder_*` functions,
+/// then formatted straight into a growable native buffer,
+/// so the output is never assembled out of Swift strings.
+enum NativeSerializer {
+    /// Returns the TOML representation of a root table as UTF-8 data.
+    static func data(for value: TOMLValue) throws -> Data {
+        guard case .table(let table) = value else { return Data() }
+        guard let builder = ctoml_builder_create() else {
+            throw TOMLEncodingError.invalidValue("Unable to create TOML document", codingPath: [])
+        }
+        defer { ctoml_builder_free(builder) }
+
+        try appendEntries(of: table, to: builder, at: .root)
+        return try write(builder)
+    }
+
+    /// Returns the TOML representation of a JSON object as UTF-8 data,
+    /// reading the JSON straight into the toml++ document without converting it to Swift values.
+    ///
+    /// - Parameter tagged: Whether objects with only `type` and `value` strings
+    ///   are toml-test's tagged values.
+    static func data(fromJSON json: Data, tagged: Bool) throws -> Data {
+        guard let builder = ctoml_builder_create() else {
+            throw TOMLEncodingError.invalidValue("Unable to create TOML document", codingPath: [])
+        }
+        defer { ctoml_builder_free(builder) }
+
+        var errorOffset = 0
+        let read = json.withUnsafeBytes { bytes in
+            ctoml_builder_read_json(
+                builder,
+                bytes.baseAddress?.assumingMemoryBound(to: CChar.self),
+                bytes.count,
+                tagged,
+                &errorOffset
+            )
+        }
+        guard read else {
+            throw TOMLEncodingError.invalidValue("Invalid JSON at byte offset \(errorOffset)", codingPath: [])
+        }
+        return try write(builder)
+    }
+
+    /// Formats a built document into a native buffer, and returns it without copying.
+    private static func write(_ builder: OpaquePointer) throws -> Data {
+        var buffer = CTomlBuffer()
+        guard ctoml_builder_write(builder, &buffer) else {
+            ctoml_buffer_free(&buffer)
+            throw TOMLEncodingError.invalidValue(
+                "Unable to write TOML document; a date may be out of range",
+                codingPath: []
+            )
+        }
+        guard let bytes = buffer.data, buffer.length > 0 else {
+            ctoml_buffer_free(&buffer)
+            return Data()
+        }
+        return Data(bytesNoCopy: bytes, count: buffer.length, deallocator: .free)
+    }
+
+    private static func appendEntries(
+        of table: TOMLValue.Table,
+        to builder: OpaquePointer,
+        at path: CodingPath
+    ) throws {
+        for (key, value) in table {
+            withChars(key) { ctoml_builder_key(builder, $0, $1) }
+            try append(value, to: builder, at: path.appending(TOMLCodingKey(stringValue: key)))
+        }
+    }
+
+    private static func append(_ value: TOMLValue, to builder: OpaquePointer, at path: CodingPath) throws {
+        switch value {
+        case .string(let s):
+            withChars(s) { ctoml_builder_string(builder, $0, $1) }
+        case .integer(let i):
+            ctoml_builder_integer(builder, i)
+        case .float(let f):
+            ctoml_builder_float(builder, f)
+        case .boolean(let b):
+            ctoml_builder_boolean(builder, b)
+        case .offsetDateTime(let date):
+            // Round to milliseconds, like the Swift serializer's ISO 8601 output.
+            let milliseconds = (date.timeIntervalSince1970 * 1000).rounded()
+            let seconds = (milliseconds / 1000).rounded(.down)
+            try TOMLSerializer.checkDateRange(seconds, of: date, codingPath: path.keys)
+            let nanoseconds = Int32((milliseconds - seconds * 1000) * 1_000_000)
+            ctoml_builder_instant(builder, Int64(seconds), nanoseconds)
+        case .localDateTime(let dt):
+            var value = CTomlDateTime()
+            value.date = CTomlDate(dt.year, dt.month, dt.day)
+            value.time = CTomlTime(dt.hour, dt.minute, dt.second, dt.nanosecond)
+            ctoml_builder_date_time(builder, value)
+        case .localDate(let d):
+            ctoml_builder_date(builder, CTomlDate(d.year, d.month, d.day))
+        case .localTime(let t):
+            ctoml_builder_time(builder, CTomlTime(t.hour, t.minute, t.second, t.nanosecond))
+        case .array(let arr):
+            ctoml_builder_begin_array(builder)
+            for (index, element) in arr.enumerated() {
+                try append(element, to: builder, at: path.appending(index: index))
+            }
+            ctoml_builder_end(builder)
+        case .table(let table):
+            ctoml_builder_begin_table(builder)
+            try appendEntries(of: table, to: builder, at: path)
+            ctoml_builder_end(builder)
+        }
+    }
+
+    private static func withChars(_ string: String, _ body: (UnsafePointer<CChar>?, Int) -> Void) {
+        var string = string
+        string.withUTF8 { utf8 in
+            utf8.withMemoryRebound(to: CChar.self) { chars in
+                body(chars.baseAddress, chars.count)
+            }
+        }
+    }
+}
+
+private extension CTomlDate {
+    init(_ year: Int, _ month: Int, _ day: Int) {
+        self.init(year: Int32(clamping: year), month: Int32(clamping: month), day: Int32(clamping: day))
+    }
+}
+
+private extension CTomlTime {
+    init(_ hour: Int, _ minute: Int, _ second: Int, _ nanosecond: Int) {
+        self.init(
+            hour: Int32(clamping: hour),
+            minute: Int32(clamping: minute),
+            second: Int32(clamping: second),
+            nanosecond: Int32(clamping: nanosecond)
+        )
+    }
+}
@@ -0,0 +1,187 @@
+import Foundation
+
+#if canImport(Darwin)
+import Darwin
+#elseif canImport(Glibc)
+import Glibc
+#elseif canImport(Musl)
+import Musl
+#endif
+
+/// A destination for TOML written by ``TOMLEncoder/encode(_:to:)``.
+///
+/// The encoder writes UTF-8 encoded TOML to the sink in chunks as it's produced,
+/// rather than building the whole document in memory first,
+/// and flushes the sink once the value has been written.
+public protocol TOMLOutputSink: AnyObject {
+    /// Writes a chunk of UTF-8 encoded TOML.
+    func write(_ bytes: UnsafeRawBufferPointer) throws
+
+    /// Writes out any output the sink has buffered.
+    func flush() throws
+}
+
+extension TOMLOutputSink {
+    public func flush() throws {}
+}
+
+// MARK: - Byte Sink
+
+/// A sink that collects TOML in a growable array of bytes.
+public final class TOMLBytesSink: TOMLOutputSink {
+    /// The bytes written so far.
+    public private(set) var bytes: [UInt8] = []
+
+    /// Creates an empty sink.
+    public init() {}
+
+    public func write(_ bytes: UnsafeRawBufferPointer) {
+        self.bytes.append(contentsOf: bytes)
+    }
+}
+
+// MARK: - File Sink
+
+/// A sink that writes TOML to a file descriptor.
+///
+/// Output is written as the encoder produces it,
+/// so at most one chunk of the document is held in memory at a time.
+/// The sink doesn't close the file descriptor.
+public final class TOMLFileSink: TOMLOutputSink {
+    /// The file descriptor written to.
+    public let fileDescriptor: Int32
+
+    /// Creates a sink that writes to a file descriptor.
+    public init(fileDescriptor: Int32) {
+        self.fileDescriptor = fileDescriptor
+    }
+
+    /// Creates a sink that writes to a file handle.
+    ///
+    /// The file handle must stay open until encoding finishes.
+    public convenience init(fileHandle: FileHandle) {
+        self.init(fileDescriptor: fileHandle.fileDescriptor)
+    }
+
+    public func write(_ bytes: UnsafeRawBufferPointer) throws {
+        guard var address = bytes.baseAddress else { return }
+        var remaining = bytes.count
+        while remaining > 0 {
+            let written = systemWrite(fileDescriptor, address, remaining)
+            if written < 0 {
+                if errno == EINTR { continue }
+                throw POSIXError(POSIXErrorCode(rawValue: errno) ?? .EIO)
+            }
+            address += written
+            remaining -= written
+        }
+    }
+}
+
+private func systemWrite(_ fd: Int32, _ buffer: UnsafeRawPointer, _ count: Int) -> Int {
+    #if canImport(Darwin)
+    return Darwin.write(fd, buffer, count)
+    #elseif canImport(Glibc)
+    return Glibc.write(fd, buffer, count)
+    #else
+    return Musl.write(fd, buffer, count)
+    #endif
+}
+
+// MARK: - Async Stream Sink
+
+/// A sink that yields TOML as chunks of bytes to an `AsyncStream`.
+///
+/// ```swift
+/// let (chunks, sink) = TOMLAsyncStreamSink.makeStream()
+/// Task {
+///     try encoder.encode(config, to: sink)
+///     sink.finish()
+/// }
+/// for await chunk in chunks {
+///     // ...
+/// }
+/// ```
+///
+/// `AsyncStream` buffers the chunks a consumer hasn't read yet,
+/// so memory use stays bounded only while the consumer keeps up.
+public final class TOMLAsyncStreamSink: TOMLOutputSink {
+    private let continuation: AsyncStream<[UInt8]>.Continuation
+
+    /// Creates a sink that yields chunks to a stream's continuation.
+    public init(_ continuation: AsyncStream<[UInt8]>.Continuation) {
+        self.continuation = continuation
+    }
+
+    /// Returns a new stream of chunks, along with a sink that yields to it.
+    public static func makeStream() -> (stream: AsyncStream<[UInt8]>, sink: TOMLAsyncStreamSink) {
+        var continuation: AsyncStream<[UInt8]>.Continuation!
+        let stream = AsyncStream<[UInt8]> { continuation = $0 }
+        return (stream, TOMLAsyncStreamSink(continuation))
+    }
+
+    public func write(_ bytes: UnsafeRawBufferPointer) {
+        continuation.yield(Array(bytes))
+    }
+
+    /// Ends the stream.
+    public func finish() {
+        continuation.finish()
+    }
+}
+
+// MARK: - Writer
+
+/// Buffers serialized TOML and passes it to a sink in chunks.
+///
+/// Without a sink, the writer keeps everything written to it,
+/// for encoding to a string or data.
+struct TOMLWriter {
+    /// The number of bytes buffered before they're written to the sink.
+    static let chunkSize = 64 * 1024
+
+    private let sink: (any TOMLOutputSink)?
+    private(set) var bytes: [UInt8] = []
+
+    init(sink: (any TOMLOutputSink)? = nil) {
+        self.sink = sink
+        if sink != nil {
+            bytes.reserveCapacity(TOMLWriter.chunkSize)
+        }
+    }
+
+    mutating func write(_ string: String) throws {
+        bytes.append(contentsOf: string.utf8)
+        if let sink, bytes.count >= TOMLWriter.chunkSize {
+            try writeBuffer(to: sink)
+        }
+    }
+
+    mutating func write(_ other: TOMLWriter) throws {
+        bytes.append(contentsOf: other.bytes)
+        if let sink, bytes.count >= TOMLWriter.chunkSize {
+            try writeBuffer(to: sink)
+        }
+    }
+
+    /// Appends bytes to the buffer directly, without going through a string.
+    mutating func append(_ body: (inout [UInt8]) throws -> Void) throws {
+        try body(&bytes)
+        if let sink, bytes.count >= TOMLWriter.chunkSize {
+            try writeBuffer(to: sink)
+        }
+    }
+
+    /// Writes buffered bytes to the sink, then flushes the sink.
+    mutating func flush() throws {
+        guard let sink else { return }
+        try writeBuffer(to: sink)
+        try sink.flush()
+    }
+
+    private mutating func writeBuffer(to sink: any TOMLOutputSink) throws {
+        guard !bytes.isEmpty else { return }
+        try bytes.withUnsafeBytes { try sink.write($0) }
+        bytes.removeAll(keepingCapacity: true)
+    }
+}
@@ -0,0 +1,221 @@
+import CTomlPlusPlus
+import Foundation
+
+/// Owns the C tree produced by `ctoml_parse`.
+///
+/// Every `CTomlNode` reachable from ``root`` points into storage
+/// that is freed when this object is deallocated,
+/// so anything holding on to a node must also hold on to its parse result.
+final class TOMLParseResult {
+    private var result: CTomlParseResult
+
+    /// The root table of the parsed document.
+    var root: CTomlNode {
+        result.root
+    }
+
+    /// Parses UTF-8 encoded TOML.
+    ///
+    /// When `rootKeys` is provided, the whole document is still parsed and checked for errors,
+    /// but only the root entries with those keys are converted;
+    /// the others are left out of ``root``,
+    /// after being checked against `limits` in their place.
+    ///
+    /// - Throws: ``TOMLDecodingError`` if the input isn't valid TOML,
+    ///   or if a root entry left out of ``root`` breaks `limits`.
+    init(
+        parsing bytes: UnsafeRawBufferPointer,
+        rootKeys: [String]? = nil,
+        limits: TOMLDecoder.DecodingLimits = .unlimited
+    ) throws {
+        let input = bytes.baseAddress?.assumingMemoryBound(to: CChar.self)
+        var result: CTomlParseResult
+        if let rootKeys {
+            var cLimits = CTomlLimits(
+                max_depth: Int64(limits.maxDepth),
+                max_table_keys: Int64(limits.maxTableKeys),
+                max_array_length: Int64(limits.maxArrayLength),
+                max_string_length: Int64(limits.maxStringLength)
+            )
+            result = TOMLParseResult.withCTomlStrings(rootKeys) { keys in
+                ctoml_parse_selected(input, bytes.count, keys.baseAddress, keys.count, &cLimits)
+            }
+        } else {
+            result = ctoml_parse(input, bytes.count)
+        }
+        guard result.success else {
+            let error = TOMLParseResult.error(from: result)
+            ctoml_free_result(&result)
+            throw error
+        }
+        self.result = result
+    }
+
+    deinit {
+        ctoml_free_result(&result)
+    }
+
+    /// Writes the document as toml-test's tagged JSON, straight from the parsed tree.
+    ///
+    /// - Throws: ``TOMLDecodingError`` if memory runs out.
+    func taggedJSON() throws -> Data {
+        var buffer = CTomlBuffer()
+        guard ctoml_to_tagged_json(&result, &buffer) else {
+            ctoml_buffer_free(&buffer)
+            throw TOMLDecodingError.invalidData("Unable to write tagged JSON")
+        }
+        guard let bytes = buffer.data, buffer.length > 0 else {
+            ctoml_buffer_free(&buffer)
+            return Data()
+        }
+        return Data(bytesNoCopy: bytes, count: buffer.length, deallocator: .free)
+    }
+
+    /// Writes the document with one of toml++'s formatters and its default flags,
+    /// passing the output to `sink` in chunks as it's produced.
+    ///
+    /// - Throws: The error thrown by `sink`, or ``TOMLEncodingError`` if formatting fails.
+    func format(_ format: CTomlFormat, to sink: any TOMLOutputSink) throws {
+        let context = FormatContext(sink: sink)
+        let formatted = withExtendedLifetime(context) {
+            ctoml_format(
+                &result,
+                format,
+                ctoml_format_default_flags(format),
+                { context, data, length in
+                    let context = Unmanaged<FormatContext>.fromOpaque(context!).takeUnretainedValue()
+                    do {
+                        try context.sink.write(UnsafeRawBufferPointer(start: data, count: length))
+                        return true
+                    } catch {
+                        context.error = error
+                        return false
+                    }
+                },
+                Unmanaged.passUnretained(context).toOpaque()
+            )
+        }
+        if let error = context.error {
+            throw error
+        }
+        guard formatted else {
+            throw TOMLEncodingError.invalidValue("Unable to format TOML document", codingPath: [])
+        }
+        try sink.flush()
+    }
+
+    /// Calls `body` with C views of `strings`, valid only for the duration of the call.
+    private static func withCTomlStrings<R>(
+        _ strings: [String],
+        _ body: (UnsafeBufferPointer<CTomlString>) -> R
+    ) -> R {
+        var storage: [UInt8] = []
+        var ranges: [(offset: Int, length: Int)] = []
+        ranges.reserveCapacity(strings.count)
+        for string in strings {
+            ranges.append((storage.count, string.utf8.count))
+            storage.append(contentsOf: string.utf8)
+        }
+        return storage.withUnsafeBytes { bytes in
+            let base = bytes.baseAddress?.assumingMemoryBound(to: CChar.self)
+            let cStrings = ranges.map { range in
+                CTomlString(data: base.map { $0 + range.offset }, length: range.length)
+            }
+            return cStrings.withUnsafeBufferPointer(body)
+        }
+    }
+
+    private static func error(from result: CTomlParseResult) -> TOMLDecodingError {
+        guard let errorMsg = result.error_message else {
+            return .invalidData("Unknown parse error")
+        }
+        let message = String(cString: errorMsg)
+        let line = Int(result.error_line)
+        let column = Int(result.error_column)
+        if line > 0 || column > 0 {
+            return .invalidSyntax(line: line, column: column, message: message)
+        }
+        return .invalidData(message)
+    }
+}
+
+// MARK: - Node Accessors
+
+extension String {
+    init(_ string: CTomlString) {
+        if let data = string.data {
+            let buffer = UnsafeRawBufferPointer(start: data, count: string.length)
+            self.init(decoding: buffer, as: UTF8.self)
+        } else {
+            self.init()
+        }
+    }
+}
+
+extension CTomlNode {
+    /// A description of the node's TOML type, for use in error messages.
+    var typeName: String {
+        switch type {
+        case CTOML_STRING: return "string"
+        case CTOML_INTEGER: return "integer"
+        case CTOML_FLOAT: return "float"
+        case CTOML_BOOLEAN: return "boolean"
+        case CTOML_DATETIME: return data.datetime_value.has_offset ? "offset date-time" : "local date-time"
+        case CTOML_DATE: return "local date"
+        case CTOML_TIME: return "local time"
+        case CTOML_ARRAY: return "array"
+        case CTOML_TABLE: return "table"
+        // Missing nodes have always been treated as empty strings.
+        default: return "string"
+        }
+    }
+}
+
+extension CTomlDate {
+    var localDate: LocalDate {
+        LocalDate(year: Int(year), month: Int(month), day: Int(day))
+    }
+}
+
+extension CTomlTime {
+    var localTime: LocalTime {
+        LocalTime(hour: Int(hour), minute: Int(minute), second: Int(second), nanosecond: Int(nanosecond))
+    }
+}
+
+extension CTomlDateTime {
+    var localDateTime: LocalDateTime {
+        LocalDateTime(
+            year: Int(date.year),
+            month: Int(date.month),
+            day: Int(date.day),
+            hour: Int(time.hour),
+            minute: Int(time.minute),
+            second: Int(time.second),
+            nanosecond: Int(time.nanosecond)
+        )
+    }
+
+    /// The instant described by an offset date-time,
+    /// or `nil` for local date-times.
+    ///
+    /// The epoch offset is computed arithmetically during conversion in C,
+    /// so no calendar or time zone objects are involved.
+    var offsetDate: Date? {
+        guard has_offset else { return nil }
+        return Date(
+            timeIntervalSince1970: TimeInterval(epoch_seconds) + TimeInterval(epoch_nanoseconds) / 1_000_000_000
+        )
+    }
+}
+
+/// The sink written to by ``TOMLParseResult/format(_:to:)``,
+/// and the first error it threw, passed through the C write callback.
+private final class FormatContext {
+    let sink: any TOMLOutputSink
+    var error: (any Error)?
+
+    init(sink: any TOMLOutputSink) {
+        self.sink = sink
+    }
+}
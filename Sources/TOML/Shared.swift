@@ -1,3 +1,5 @@
+import Foundation
+
 struct TOMLCodingKey: CodingKey {
     var stringValue: String
     var intValue: Int?
@@ -17,3 +19,93 @@ struct TOMLCodingKey: CodingKey {
         self.intValue = index
     }
 }
+
+/// The coding path of a decoder, encoder, or container, stored as a linked list.
+///
+/// Coding paths are read almost exclusively to report errors,
+/// so rather than copying the parent's keys into a new array for every nested value,
+/// each path refers to its parent's path and adds a single component.
+/// Array indices are stored as integers,
+/// and only become `CodingKey` values when the path is read with ``keys``.
+final class CodingPath: @unchecked Sendable {
+    private enum Component {
+        case key(any CodingKey)
+        case index(Int)
+    }
+
+    private let parent: CodingPath?
+    private let component: Component?
+
+    /// The empty path, at the top level of a document.
+    static let root = CodingPath(parent: nil, component: nil)
+
+    private init(parent: CodingPath?, component: Component?) {
+        self.parent = parent
+        self.component = component
+    }
+
+    /// Returns the path to a value for the given key under this path.
+    func appending(_ key: any CodingKey) -> CodingPath {
+        CodingPath(parent: self, component: .key(key))
+    }
+
+    /// Returns the path to an array element under this path.
+    func appending(index: Int) -> CodingPath {
+        CodingPath(parent: self, component: .index(index))
+    }
+
+    /// The keys of the path, starting from the top level.
+    var keys: [any CodingKey] {
+        var keys: [any CodingKey] = []
+        var path = self
+        while let component = path.component, let parent = path.parent {
+            switch component {
+            case .key(let key):
+                keys.append(key)
+            case .index(let index):
+                keys.append(TOMLCodingKey(index: index))
+            }
+            path = parent
+        }
+        return keys.reversed()
+    }
+}
+
+/// A process-wide cache of key strategy conversions, keyed by `CodingKey` type.
+///
+/// Strategies like `.convertFromSnakeCase` build a new string for every key,
+/// and the same handful of keys are converted once per field of every table decoded or encoded.
+/// Each key type gets its own table of results,
+/// capped so that types with unbounded key sets, such as dictionary keys, can't grow it forever.
+final class KeyConversionCache: @unchecked Sendable {
+    /// The maximum number of conversions cached for a single key type.
+    static let maximumKeysPerType = 1024
+
+    private let lock = NSLock()
+    private var tables: [ObjectIdentifier: [String: String]] = [:]
+    private let transform: @Sendable (String) -> String
+
+    init(_ transform: @escaping @Sendable (String) -> String) {
+        self.transform = transform
+    }
+
+    func convert(_ key: any CodingKey) -> String {
+        let keyType = ObjectIdentifier(type(of: key))
+        let stringValue = key.stringValue
+
+        lock.lock()
+        let cached = tables[keyType]?[stringValue]
+        lock.unlock()
+        if let cached {
+            return cached
+        }
+
+        let converted = transform(stringValue)
+        lock.lock()
+        if tables[keyType, default: [:]].count < KeyConversionCache.maximumKeysPerType {
+            tables[keyType, default: [:]][stringValue] = converted
+        }
+        lock.unlock()
+        return converted
+    }
+}
@@ -0,0 +1,320 @@
+import Foundation
+
+// MARK: - Table Output
+
+/// The output of one table during single-pass encoding.
+///
+/// Key-value pairs are written as soon as they're encoded:
+/// the root table's straight to the encoder's writer,
+/// and a sub-table's into its parent's deferred sections, just after its header.
+/// Sub-tables and arrays of tables are written into the table's own deferred sections,
+/// which are appended to the output once the table is complete.
+final class TOMLTableOutput {
+    /// The keys of the table, from the root.
+    let path: [String]
+
+    private let serializer: TOMLSerializer
+    private let parent: TOMLTableOutput?
+    private var writer: TOMLWriter
+    private var deferred = TOMLWriter()
+
+    /// Encoders for nested containers and super encoders,
+    /// which can still be written to after their parent moves on to other keys,
+    /// so their values are written when the table is complete.
+    private var pending: [(key: String?, encoder: _TOMLEncoder)] = []
+
+    /// Creates the output for the root table.
+    init(root writer: TOMLWriter, serializer: TOMLSerializer) {
+        self.path = []
+        self.serializer = serializer
+        self.parent = nil
+        self.writer = writer
+    }
+
+    /// Creates the output for a sub-table and writes its header.
+    init(key: String, parent: TOMLTableOutput) {
+        self.path = parent.path + [key]
+        self.serializer = parent.serializer
+        self.parent = parent
+        self.writer = TOMLWriter()
+        // Deferred sections have no sink, so writing to them can't fail.
+        try? parent.deferred.write("\n[\(path.map(serializer.escapeKey).joined(separator: "."))]\n")
+    }
+
+    /// Writes a value in the table,
+    /// either as a key-value pair or, for tables and arrays of tables, as a deferred section.
+    func write(_ value: TOMLValue, forKey key: String) throws {
+        if value.isTable || value.isArrayOfTables {
+            try serializer.serializeSection(value, to: &deferred, path: path + [key])
+        } else if let parent {
+            try serializer.serializeKeyValue(key, value, to: &parent.deferred)
+        } else {
+            try serializer.serializeKeyValue(key, value, to: &writer)
+        }
+    }
+
+    /// Adds an encoder whose value is written when the table is complete.
+    ///
+    /// Encoders without a key contribute their table's entries to this table.
+    func addPending(_ encoder: _TOMLEncoder, forKey key: String?) {
+        pending.append((key, encoder))
+    }
+
+    /// Writes pending values, then the deferred sections, after the table's key-value pairs.
+    ///
+    /// - Returns: For the root table, the writer with the whole document.
+    @discardableResult
+    func finish() throws -> TOMLWriter {
+        for (key, encoder) in pending {
+            guard let value = encoder.value else { continue }
+            if let key {
+                try write(value, forKey: key)
+            } else if case .table(let table) = value {
+                for (key, value) in table {
+                    try write(value, forKey: key)
+                }
+            }
+        }
+        pending = []
+
+        if let parent {
+            try parent.deferred.write(deferred)
+        } else {
+            try writer.write(deferred)
+        }
+        deferred = TOMLWriter()
+        return writer
+    }
+}
+
+// MARK: - Single-Pass Encoder
+
+/// Encodes values straight to TOML text, without building a tree of values for tables.
+///
+/// Values that ask for a keyed container are written as tables through ``TOMLTableOutput``.
+/// Values that ask for an unkeyed or single value container are encoded
+/// with the tree encoder, and written once they're complete.
+final class _TOMLSinglePassEncoder: Encoder {
+    let path: CodingPath
+    var codingPath: [any CodingKey] { path.keys }
+    var userInfo: [CodingUserInfoKey: Any]
+    let options: EncodingOptions
+
+    private let serializer: TOMLSerializer
+    private let parent: TOMLTableOutput?
+    private let key: String
+    private var root: TOMLWriter?
+    private var table: TOMLTableOutput?
+    private var fallback: _TOMLEncoder?
+
+    /// Creates an encoder for the root of a document, which writes to `output`.
+    init(userInfo: [CodingUserInfoKey: Any], options: EncodingOptions, serializer: TOMLSerializer, output: TOMLWriter) {
+        self.path = .root
+        self.userInfo = userInfo
+        self.options = options
+        self.serializer = serializer
+        self.parent = nil
+        self.key = ""
+        self.root = output
+    }
+
+    /// Creates an encoder for the value of a key in a table.
+    private init(path: CodingPath, key: String, parent: TOMLTableOutput, encoder: _TOMLSinglePassEncoder) {
+        self.path = path
+        self.userInfo = encoder.userInfo
+        self.options = encoder.options
+        self.serializer = encoder.serializer
+        self.parent = parent
+        self.key = key
+    }
+
+    func container<Key: CodingKey>(keyedBy type: Key.Type) -> KeyedEncodingContainer<Key> {
+        let table: TOMLTableOutput
+        if let existing = self.table {
+            table = existing
+        } else if let parent {
+            table = TOMLTableOutput(key: key, parent: parent)
+        } else {
+            table = TOMLTableOutput(root: root ?? TOMLWriter(), serializer: serializer)
+        }
+        self.table = table
+
+        let container = TOMLSinglePassKeyedEncodingContainer<Key>(encoder: self, table: table, path: path)
+        return KeyedEncodingContainer(container)
+    }
+
+    func unkeyedContainer() -> any UnkeyedEncodingContainer {
+        fallbackEncoder().unkeyedContainer()
+    }
+
+    func singleValueContainer() -> any SingleValueEncodingContainer {
+        fallbackEncoder().singleValueContainer()
+    }
+
+    private func fallbackEncoder() -> _TOMLEncoder {
+        if let fallback {
+            return fallback
+        }
+        let encoder = _TOMLEncoder(path: path, userInfo: userInfo, options: options)
+        fallback = encoder
+        return encoder
+    }
+
+    /// Encodes the value of a key in a table, writing it to the table.
+    func encode<T: Encodable>(_ value: T, forKey key: any CodingKey, name: String, in table: TOMLTableOutput) throws {
+        // Dates and types with their own TOML encoding are boxed like the tree encoder does,
+        // before `encode(to:)` would lose the date encoding strategy.
+        if value is Date || value is LocalDateTime || value is LocalDate || value is LocalTime
+            || value is any TOMLEncodable
+        {
+            let encoder = _TOMLEncoder(path: path.appending(key), userInfo: userInfo, options: options)
+            try table.write(encoder.box(value, at: encoder.path), forKey: name)
+            return
+        }
+
+        let encoder = _TOMLSinglePassEncoder(path: path.appending(key), key: name, parent: table, encoder: self)
+        try value.encode(to: encoder)
+
+        if let nested = encoder.table {
+            try nested.finish()
+        } else if let boxed = encoder.fallback?.value {
+            try table.write(boxed, forKey: name)
+        } else {
+            throw TOMLEncodingError.invalidValue("Unable to encode \(T.self)", codingPath: encoder.codingPath)
+        }
+    }
+
+    /// Completes the document and returns the writer holding it.
+    func finish() throws -> TOMLWriter {
+        if let table {
+            return try table.finish()
+        }
+        guard var output = root, let value = fallback?.value else {
+            throw TOMLEncodingError.invalidValue("No value encoded", codingPath: [])
+        }
+        try serializer.serializeTable(value, to: &output, path: [])
+        return output
+    }
+
+    func convertKey(_ key: any CodingKey) -> String {
+        switch options.keyEncodingStrategy {
+        case .useDefaultKeys:
+            return key.stringValue
+        case .convertToSnakeCase:
+            return toSnakeCaseKeys.convert(key)
+        }
+    }
+}
+
+// MARK: - Keyed Encoding Container
+
+private struct TOMLSinglePassKeyedEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProtocol {
+    let path: CodingPath
+    var codingPath: [any CodingKey] { path.keys }
+    let encoder: _TOMLSinglePassEncoder
+    let table: TOMLTableOutput
+
+    init(encoder: _TOMLSinglePassEncoder, table: TOMLTableOutput, path: CodingPath) {
+        self.encoder = encoder
+        self.table = table
+        self.path = path
+    }
+
+    private func write(_ value: TOMLValue, forKey key: Key) throws {
+        try table.write(value, forKey: encoder.convertKey(key))
+    }
+
+    mutating func encodeNil(forKey key: Key) throws {
+    }
+
+    mutating func encode(_ value: Bool, forKey key: Key) throws {
+        try write(.boolean(value), forKey: key)
+    }
+
+    mutating func encode(_ value: String, forKey key: Key) throws {
+        try write(.string(value), forKey: key)
+    }
+
+    mutating func encode(_ value: Double, forKey key: Key) throws {
+        try write(.float(value), forKey: key)
+    }
+
+    mutating func encode(_ value: Float, forKey key: Key) throws {
+        try write(.float(Double(value)), forKey: key)
+    }
+
+    mutating func encode(_ value: Int, forKey key: Key) throws {
+        try write(.integer(Int64(value)), forKey: key)
+    }
+
+    mutating func encode(_ value: Int8, forKey key: Key) throws {
+        try write(.integer(Int64(value)), forKey: key)
+    }
+
+    mutating func encode(_ value: Int16, forKey key: Key) throws {
+        try write(.integer(Int64(value)), forKey: key)
+    }
+
+    mutating func encode(_ value: Int32, forKey key: Key) throws {
+        try write(.integer(Int64(value)), forKey: key)
+    }
+
+    mutating func encode(_ value: Int64, forKey key: Key) throws {
+        try write(.integer(value), forKey: key)
+    }
+
+    mutating func encode(_ value: UInt, forKey key: Key) throws {
+        try write(.integer(Int64(value)), forKey: key)
+    }
+
+    mutating func encode(_ value: UInt8, forKey key: Key) throws {
+        try write(.integer(Int64(value)), forKey: key)
+    }
+
+    mutating func encode(_ value: UInt16, forKey key: Key) throws {
+        try write(.integer(Int64(value)), forKey: key)
+    }
+
+    mutating func encode(_ value: UInt32, forKey key: Key) throws {
+        try write(.integer(Int64(value)), forKey: key)
+    }
+
+    mutating func encode(_ value: UInt64, forKey key: Key) throws {
+        try write(.integer(Int64(value)), forKey: key)
+    }
+
+    mutating func encode<T: Encodable>(_ value: T, forKey key: Key) throws {
+        try encoder.encode(value, forKey: key, name: encoder.convertKey(key), in: table)
+    }
+
+    mutating func nestedContainer<NestedKey: CodingKey>(
+        keyedBy keyType: NestedKey.Type,
+        forKey key: Key
+    ) -> KeyedEncodingContainer<NestedKey> {
+        pendingEncoder(forKey: key).container(keyedBy: keyType)
+    }
+
+    mutating func nestedUnkeyedContainer(forKey key: Key) -> any UnkeyedEncodingContainer {
+        pendingEncoder(forKey: key).unkeyedContainer()
+    }
+
+    mutating func superEncoder() -> any Encoder {
+        let nestedEncoder = _TOMLEncoder(path: path, userInfo: encoder.userInfo, options: encoder.options)
+        table.addPending(nestedEncoder, forKey: nil)
+        return nestedEncoder
+    }
+
+    mutating func superEncoder(forKey key: Key) -> any Encoder {
+        pendingEncoder(forKey: key)
+    }
+
+    private func pendingEncoder(forKey key: Key) -> _TOMLEncoder {
+        let nestedEncoder = _TOMLEncoder(
+            path: path.appending(key),
+            userInfo: encoder.userInfo,
+            options: encoder.options
+        )
+        table.addPending(nestedEncoder, forKey: encoder.convertKey(key))
+        return nestedEncoder
+    }
+}
@@ -0,0 +1,222 @@
+import CTomlPlusPlus
+import Foundation
+
+/// A type that can decode itself directly from a parsed TOML table.
+///
+/// When ``TOMLDecoder`` decodes a table into a type that conforms to `TOMLDecodable`,
+/// it calls ``init(toml:)`` instead of `init(from:)`,
+/// skipping the `Decoder` container machinery for that type.
+/// Conformances look up keys directly in the parsed document
+/// and read scalars without intermediate conversions:
+///
+/// ```swift
+/// struct Server: Codable, TOMLDecodable {
+///     var host: String
+///     var port: Int
+///
+///     init(toml table: TOMLDocument.Table) throws {
+///         host = try table.decode(String.self, forKey: "host")
+///         port = try table.decode(Int.self, forKey: "port")
+///     }
+/// }
+/// ```
+///
+/// Keys are matched exactly as written;
+/// the decoder's ``TOMLDecoder/keyDecodingStrategy`` doesn't apply.
+///
+/// For a struct, attach the ``TOMLCodable()`` macro to generate this conformance instead.
+public protocol TOMLDecodable: Decodable {
+    /// Creates a value from a TOML table.
+    init(toml table: TOMLDocument.Table) throws
+}
+
+/// A type that can encode itself directly into a TOML table.
+///
+/// When ``TOMLEncoder`` encodes a value that conforms to `TOMLEncodable`,
+/// it calls ``encode(toml:)`` instead of `encode(to:)`,
+/// skipping the `Encoder` container machinery for that type:
+///
+/// ```swift
+/// extension Server: TOMLEncodable {
+///     func encode(toml encoder: inout TOMLTableEncoder) throws {
+///         try encoder.encode(host, forKey: "host")
+///         try encoder.encode(port, forKey: "port")
+///     }
+/// }
+/// ```
+///
+/// Keys are written exactly as given;
+/// the encoder's ``TOMLEncoder/keyEncodingStrategy`` doesn't apply.
+///
+/// For a struct, attach the ``TOMLCodable()`` macro to generate this conformance instead.
+public protocol TOMLEncodable: Encodable {
+    /// Encodes this value's fields into a table.
+    func encode(toml encoder: inout TOMLTableEncoder) throws
+}
+
+/// A type that can decode itself from and encode itself to TOML tables directly.
+public typealias TOMLCodable = TOMLDecodable & TOMLEncodable
+
+/// Generates ``TOMLDecodable`` and ``TOMLEncodable`` conformances for a `Codable` struct.
+///
+/// The generated ``TOMLDecodable/init(toml:)`` and ``TOMLEncodable/encode(toml:)``
+/// read and write each stored property directly,
+/// under the same key as the struct's `Codable` conformance:
+///
+/// ```swift
+/// @TOMLCodable
+/// struct Server: Codable {
+///     var host: String
+///     var port: Int?
+/// }
+/// ```
+///
+/// Keys come from the struct's `CodingKeys` enumeration if it declares one;
+/// otherwise each property is stored under its name.
+/// Optional properties may be missing from the table,
+/// and constants with an initial value are skipped, as they are by `Codable`.
+@attached(extension, conformances: TOMLDecodable, TOMLEncodable, names: named(init(toml:)), named(encode(toml:)))
+public macro TOMLCodable() = #externalMacro(module: "TOMLMacros", type: "TOMLCodableMacro")
+
+// MARK: - Decoding
+
+extension TOMLDocument.Table {
+    /// Decodes the value for a key.
+    ///
+    /// Strings, integers, floats, and booleans are read directly from the document;
+    /// other types are decoded with `init(from:)`,
+    /// using the options of the decoder that produced this table.
+    ///
+    /// - Throws: `DecodingError` if the key is missing or the value has the wrong type.
+    public func decode<T: Decodable>(_ type: T.Type, forKey key: String) throws -> T {
+        guard let node = self[key] else {
+            let codingKey = TOMLCodingKey(stringValue: key)
+            throw DecodingError.keyNotFound(
+                codingKey,
+                DecodingError.Context(codingPath: self.node.path.keys, debugDescription: "Key '\(key)' not found")
+            )
+        }
+        return try node.decode(type)
+    }
+
+    /// Decodes the value for a key, or returns `nil` if the table doesn't contain it.
+    ///
+    /// - Throws: `DecodingError` if the value has the wrong type.
+    public func decodeIfPresent<T: Decodable>(_ type: T.Type, forKey key: String) throws -> T? {
+        guard let node = self[key] else { return nil }
+        return try node.decode(type)
+    }
+}
+
+extension TOMLDocument.Node {
+    /// Decodes this value as the given type.
+    ///
+    /// - Throws: `DecodingError` if the value has the wrong type.
+    public func decode<T: Decodable>(_ type: T.Type) throws -> T {
+        if type == String.self, node.type == CTOML_STRING {
+            return String(node.data.string_value) as! T
+        }
+        if type == Int.self, node.type == CTOML_INTEGER {
+            return Int(node.data.integer_value) as! T
+        }
+        if type == Int64.self, node.type == CTOML_INTEGER {
+            return node.data.integer_value as! T
+        }
+        if type == Double.self, node.type == CTOML_FLOAT {
+            return node.data.float_value as! T
+        }
+        if type == Bool.self, node.type == CTOML_BOOLEAN {
+            return node.data.boolean_value as! T
+        }
+
+        // Everything else, including type mismatches, goes through Codable,
+        // which handles conversions and reports errors consistently.
+        let decoder = _TOMLDecoder(
+            node: node,
+            document: document,
+            path: path,
+            userInfo: userInfo,
+            options: options,
+            plans: plans ?? DecodingPlans(keyDecodingStrategy: options.keyDecodingStrategy)
+        )
+        return try decoder.singleValueContainer().decode(type)
+    }
+}
+
+// MARK: - Encoding
+
+/// Collects the fields of a ``TOMLEncodable`` value into a table.
+public struct TOMLTableEncoder {
+    /// The fields encoded so far, in the order they were encoded.
+    public private(set) var table: TOMLValue.Table = [:]
+
+    let options: EncodingOptions
+    let userInfo: [CodingUserInfoKey: Any]
+
+    /// The coding path of the table, for errors reported while encoding its fields.
+    let path: CodingPath
+
+    init(options: EncodingOptions, userInfo: [CodingUserInfoKey: Any], path: CodingPath) {
+        self.options = options
+        self.userInfo = userInfo
+        self.path = path
+    }
+
+    /// Encodes a value for a key.
+    ///
+    /// Strings, integers, floats, booleans, and other ``TOMLEncodable`` values
+    /// are stored directly; other types are encoded with `encode(to:)`,
+    /// using the options of the encoder that's encoding this table.
+    public mutating func encode<T: Encodable>(_ value: T, forKey key: String) throws {
+        table[key] = try box(value, forKey: key)
+    }
+
+    /// Encodes a value for a key if it isn't `nil`.
+    public mutating func encodeIfPresent<T: Encodable>(_ value: T?, forKey key: String) throws {
+        guard let value else { return }
+        try encode(value, forKey: key)
+    }
+
+    private func box<T: Encodable>(_ value: T, forKey key: String) throws -> TOMLValue {
+        switch value {
+        case let string as String:
+            return .string(string)
+        case let int as Int:
+            return .integer(Int64(int))
+        case let int as Int64:
+            return .integer(int)
+        case let double as Double:
+            return .float(double)
+        case let bool as Bool:
+            return .boolean(bool)
+        case let encodable as any TOMLEncodable:
+            let path = path.appending(TOMLCodingKey(stringValue: key))
+            return .table(try encodable.tomlTable(options: options, userInfo: userInfo, path: path))
+        default:
+            let encoder = _TOMLEncoder(
+                path: path.appending(TOMLCodingKey(stringValue: key)),
+                userInfo: userInfo,
+                options: options
+            )
+            var container = encoder.singleValueContainer()
+            try container.encode(value)
+            guard let boxed = encoder.value else {
+                throw TOMLEncodingError.invalidValue("Unable to encode \(T.self)", codingPath: encoder.codingPath)
+            }
+            return boxed
+        }
+    }
+}
+
+extension TOMLEncodable {
+    /// Encodes this value into a new table.
+    func tomlTable(
+        options: EncodingOptions,
+        userInfo: [CodingUserInfoKey: Any],
+        path: CodingPath
+    ) throws -> TOMLValue.Table {
+        var encoder = TOMLTableEncoder(options: options, userInfo: userInfo, path: path)
+        try encode(toml: &encoder)
+        return encoder.table
+    }
+}
@@ -0,0 +1,174 @@
+extension TOMLValue {
+    /// An ordered collection of key-value pairs for a TOML table.
+    ///
+    /// Keys keep the order they were inserted in.
+    /// Tables decoded from a document, such as with `TOMLDecoder.decodeValue(from:)`,
+    /// have their keys in the order they appear in the document.
+    /// Most TOML tables have only a handful of keys,
+    /// so small tables are stored as a single array of entries and searched linearly,
+    /// avoiding the hashing and allocation of a `Dictionary`.
+    /// Once a table grows past ``indexThreshold`` keys,
+    /// a hashed index is built alongside the entries to keep lookups constant-time.
+    ///
+    /// Two tables are equal if they contain the same keys with equal values,
+    /// regardless of order.
+    public struct Table: Sendable, Equatable {
+        /// The number of keys above which a hashed index is maintained.
+        public static let indexThreshold = 8
+
+        private var entries: ContiguousArray<(key: String, value: TOMLValue)>
+        private var hashedIndex: [String: Int]?
+
+        /// Creates an empty table.
+        public init() {
+            entries = []
+            hashedIndex = nil
+        }
+
+        /// Creates an empty table with space for at least the specified number of keys.
+        public init(minimumCapacity: Int) {
+            self.init()
+            entries.reserveCapacity(minimumCapacity)
+        }
+
+        /// Creates a table from a sequence of key-value pairs, preserving their order.
+        ///
+        /// - Precondition: The sequence must not contain duplicate keys.
+        public init<S: Sequence>(uniqueKeysWithValues pairs: S) where S.Element == (String, TOMLValue) {
+            self.init(minimumCapacity: pairs.underestimatedCount)
+            for (key, value) in pairs {
+                precondition(self[key] == nil, "Duplicate key '\(key)' in table")
+                append(value, forKey: key)
+            }
+        }
+
+        /// Creates a table from a dictionary.
+        ///
+        /// The resulting order is the dictionary's iteration order.
+        public init(_ dictionary: [String: TOMLValue]) {
+            self.init(minimumCapacity: dictionary.count)
+            for (key, value) in dictionary {
+                append(value, forKey: key)
+            }
+        }
+
+        /// Creates a table from entries whose keys are known to be unique.
+        init(uniqueEntries entries: ContiguousArray<(key: String, value: TOMLValue)>) {
+            self.entries = entries
+            hashedIndex = nil
+            if entries.count > Table.indexThreshold {
+                rebuildIndex()
+            }
+        }
+
+        /// The table's keys, in order.
+        public var keys: [String] {
+            entries.map(\.key)
+        }
+
+        /// The table's values, in the same order as their keys.
+        public var values: [TOMLValue] {
+            entries.map(\.value)
+        }
+
+        /// Accesses the value for a key.
+        ///
+        /// Assigning a value to an existing key replaces it in place;
+        /// assigning to a new key appends it to the end.
+        /// Assigning `nil` removes the key.
+        public subscript(key: String) -> TOMLValue? {
+            get {
+                guard let position = position(of: key) else { return nil }
+                return entries[position].value
+            }
+            set {
+                if let newValue {
+                    if let position = position(of: key) {
+                        entries[position].value = newValue
+                    } else {
+                        append(newValue, forKey: key)
+                    }
+                } else {
+                    removeValue(forKey: key)
+                }
+            }
+        }
+
+        /// Removes a key and its value, returning the value if the key was present.
+        @discardableResult
+        public mutating func removeValue(forKey key: String) -> TOMLValue? {
+            guard let position = position(of: key) else { return nil }
+            let value = entries.remove(at: position).value
+            if entries.count > Table.indexThreshold {
+                rebuildIndex()
+            } else {
+                hashedIndex = nil
+            }
+            return value
+        }
+
+        /// Returns a `Dictionary` with the same contents.
+        public var dictionary: [String: TOMLValue] {
+            Dictionary(uniqueKeysWithValues: entries.lazy.map { ($0.key, $0.value) })
+        }
+
+        public static func == (lhs: Table, rhs: Table) -> Bool {
+            guard lhs.count == rhs.count else { return false }
+            if lhs.entries.elementsEqual(rhs.entries, by: { $0.key == $1.key && $0.value == $1.value }) {
+                return true
+            }
+            for (key, value) in lhs {
+                guard rhs[key] == value else { return false }
+            }
+            return true
+        }
+
+        // MARK: - Private
+
+        private func position(of key: String) -> Int? {
+            if let hashedIndex {
+                return hashedIndex[key]
+            }
+            return entries.firstIndex { $0.key == key }
+        }
+
+        private mutating func append(_ value: TOMLValue, forKey key: String) {
+            entries.append((key, value))
+            if hashedIndex != nil {
+                hashedIndex?[key] = entries.count - 1
+            } else if entries.count > Table.indexThreshold {
+                rebuildIndex()
+            }
+        }
+
+        private mutating func rebuildIndex() {
+            var hashedIndex: [String: Int] = [:]
+            hashedIndex.reserveCapacity(entries.count)
+            for (position, entry) in entries.enumerated() {
+                hashedIndex[entry.key] = position
+            }
+            self.hashedIndex = hashedIndex
+        }
+    }
+}
+
+// MARK: - RandomAccessCollection
+
+extension TOMLValue.Table: RandomAccessCollection {
+    public typealias Element = (key: String, value: TOMLValue)
+
+    public var startIndex: Int { 0 }
+    public var endIndex: Int { entries.count }
+
+    public subscript(position: Int) -> Element {
+        entries[position]
+    }
+}
+
+// MARK: - ExpressibleByDictionaryLiteral
+
+extension TOMLValue.Table: ExpressibleByDictionaryLiteral {
+    public init(dictionaryLiteral elements: (String, TOMLValue)...) {
+        self.init(uniqueKeysWithValues: elements)
+    }
+}
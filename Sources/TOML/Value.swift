@@ -39,6 +39,11 @@ public enum TOMLValue: Sendable, Equatable {
     /// An array of TOML values.
     case array([TOMLValue])
 
-    /// A table (dictionary) of string keys to TOML values.
-    case table([String: TOMLValue])
+    /// A table of string keys to TOML values.
+    ///
+    /// Tables preserve the order their keys were inserted in,
+    /// and tables decoded from a document keep the order of the document's keys.
+    /// Because ``Table`` is expressible by a dictionary literal,
+    /// you can write `.table(["key": .string("value")])`.
+    case table(Table)
 }
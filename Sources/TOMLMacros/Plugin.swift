@@ -0,0 +1,9 @@
+import SwiftCompilerPlugin
+import SwiftSyntaxMacros
+
+@main
+struct TOMLMacrosPlugin: CompilerPlugin {
+    let providingMacros: [any Macro.Type] = [
+        TOMLCodableMacro.self
+    ]
+}
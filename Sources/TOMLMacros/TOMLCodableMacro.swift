@@ -0,0 +1,268 @@
+import SwiftSyntax
+import SwiftSyntaxMacros
+
+/// Generates `TOMLDecodable` and `TOMLEncodable` conformances for a struct from its stored properties.
+///
+/// The generated `init(toml:)` and `encode(toml:)` read and write each stored property
+/// under the key its synthesized `Codable` conformance would use:
+/// the raw value of its `CodingKeys` case if the struct declares one, or else its name.
+/// Optional properties are decoded with `decodeIfPresent` and encoded with `encodeIfPresent`,
+/// and constants with an initial value are skipped, as they are by `Codable`.
+public struct TOMLCodableMacro: ExtensionMacro {
+    public static func expansion(
+        of node: AttributeSyntax,
+        attachedTo declaration: some DeclGroupSyntax,
+        providingExtensionsOf type: some TypeSyntaxProtocol,
+        conformingTo protocols: [TypeSyntax],
+        in context: some MacroExpansionContext
+    ) throws -> [ExtensionDeclSyntax] {
+        guard let structDecl = declaration.as(StructDeclSyntax.self) else {
+            throw TOMLCodableMacroError.notAStruct
+        }
+
+        // Only add the conformances the type doesn't already have.
+        let decodable = protocols.contains { $0.trimmedDescription.hasSuffix("TOMLDecodable") }
+        let encodable = protocols.contains { $0.trimmedDescription.hasSuffix("TOMLEncodable") }
+        guard decodable || encodable else { return [] }
+
+        let fields = try fields(of: structDecl)
+        let access = accessModifier(of: structDecl)
+        var conformances: [String] = []
+        var members: [String] = []
+
+        if decodable {
+            conformances.append("TOML.TOMLDecodable")
+            let lines = fields.map { field in
+                let method = field.isOptional ? "decodeIfPresent" : "decode"
+                let read = "try table.\(method)(\(field.metatype), forKey: \(field.keyLiteral))"
+                return "        self.\(field.name) = \(read)"
+            }
+            members.append(
+                """
+                    \(access)init(toml table: TOML.TOMLDocument.Table) throws {
+                \(lines.joined(separator: "\n"))
+                    }
+                """
+            )
+        }
+
+        if encodable {
+            conformances.append("TOML.TOMLEncodable")
+            let lines = fields.map { field in
+                let method = field.isOptional ? "encodeIfPresent" : "encode"
+                return "        try encoder.\(method)(self.\(field.name), forKey: \(field.keyLiteral))"
+            }
+            members.append(
+                """
+                    \(access)func encode(toml encoder: inout TOML.TOMLTableEncoder) throws {
+                \(lines.joined(separator: "\n"))
+                    }
+                """
+            )
+        }
+
+        let extensionDecl: DeclSyntax = """
+            extension \(type.trimmed): \(raw: conformances.joined(separator: ", ")) {
+            \(raw: members.joined(separator: "\n\n"))
+            }
+            """
+        return [extensionDecl.cast(ExtensionDeclSyntax.self)]
+    }
+
+    // MARK: - Fields
+
+    /// A stored property that's decoded and encoded.
+    private struct Field {
+        /// The property's name, as written in the declaration.
+        let name: String
+
+        /// The key the property is stored under.
+        let key: String
+
+        /// The property's type, or the wrapped type if it's optional.
+        let type: String
+
+        let isOptional: Bool
+
+        var keyLiteral: String {
+            StringLiteralExprSyntax(content: key).description
+        }
+
+        var metatype: String {
+            type.contains(" ") ? "(\(type)).self" : "\(type).self"
+        }
+    }
+
+    private static func fields(of structDecl: StructDeclSyntax) throws -> [Field] {
+        let codingKeys = codingKeys(of: structDecl)
+        var fields: [Field] = []
+
+        for member in structDecl.memberBlock.members {
+            guard let variable = member.decl.as(VariableDeclSyntax.self), isStored(variable) else {
+                continue
+            }
+            let isConstant = variable.bindingSpecifier.tokenKind == .keyword(.let)
+
+            // In `var a, b: Int`, `a` takes its type from `b`.
+            var nextType: TypeSyntax?
+            var bindings: [(binding: PatternBindingSyntax, type: TypeSyntax?)] = []
+            for binding in variable.bindings.reversed() {
+                nextType = binding.typeAnnotation?.type ?? (binding.initializer == nil ? nextType : nil)
+                bindings.insert((binding, nextType), at: 0)
+            }
+
+            for (binding, type) in bindings {
+                guard let identifier = binding.pattern.as(IdentifierPatternSyntax.self)?.identifier else {
+                    continue
+                }
+                let name = identifier.text
+                let plainName = unescaped(name)
+                let hasDefault = binding.initializer != nil
+                if isConstant && hasDefault {
+                    continue
+                }
+                guard let type else {
+                    throw TOMLCodableMacroError.missingType(plainName)
+                }
+
+                let wrapped = wrappedType(ofOptional: type)
+                let key: String
+                if let codingKeys {
+                    guard let codingKey = codingKeys[plainName] else {
+                        guard hasDefault || (wrapped != nil && !isConstant) else {
+                            throw TOMLCodableMacroError.missingKey(plainName)
+                        }
+                        continue
+                    }
+                    key = codingKey
+                } else {
+                    key = plainName
+                }
+
+                fields.append(
+                    Field(
+                        name: name,
+                        key: key,
+                        type: wrapped ?? type.trimmedDescription,
+                        isOptional: wrapped != nil
+                    )
+                )
+            }
+        }
+        return fields
+    }
+
+    /// Returns whether a variable declaration declares stored instance properties.
+    private static func isStored(_ variable: VariableDeclSyntax) -> Bool {
+        for modifier in variable.modifiers {
+            switch modifier.name.tokenKind {
+            case .keyword(.static), .keyword(.class), .keyword(.lazy):
+                return false
+            default:
+                continue
+            }
+        }
+        for binding in variable.bindings {
+            switch binding.accessorBlock?.accessors {
+            case nil:
+                continue
+            case .getter:
+                return false
+            case .accessors(let accessors):
+                for accessor in accessors {
+                    switch accessor.accessorSpecifier.tokenKind {
+                    case .keyword(.willSet), .keyword(.didSet):
+                        continue
+                    default:
+                        return false
+                    }
+                }
+            }
+        }
+        return true
+    }
+
+    /// Returns the keys of the struct's `CodingKeys` enumeration by case name,
+    /// or `nil` if it doesn't declare one.
+    private static func codingKeys(of structDecl: StructDeclSyntax) -> [String: String]? {
+        for member in structDecl.memberBlock.members {
+            guard let enumDecl = member.decl.as(EnumDeclSyntax.self), enumDecl.name.text == "CodingKeys" else {
+                continue
+            }
+            var keys: [String: String] = [:]
+            for enumMember in enumDecl.memberBlock.members {
+                guard let caseDecl = enumMember.decl.as(EnumCaseDeclSyntax.self) else { continue }
+                for element in caseDecl.elements {
+                    let name = unescaped(element.name.text)
+                    let rawValue = element.rawValue?.value.as(StringLiteralExprSyntax.self)?.representedLiteralValue
+                    keys[name] = rawValue ?? name
+                }
+            }
+            return keys
+        }
+        return nil
+    }
+
+    /// Returns an identifier without the backticks that escape a keyword, such as `` `default` ``.
+    private static func unescaped(_ identifier: String) -> String {
+        identifier.filter { $0 != "`" }
+    }
+
+    /// Returns the wrapped type of `T?`, `T!`, or `Optional<T>`, or `nil` if `type` isn't optional.
+    private static func wrappedType(ofOptional type: TypeSyntax) -> String? {
+        if let optional = type.as(OptionalTypeSyntax.self) {
+            return optional.wrappedType.trimmedDescription
+        }
+        if let optional = type.as(ImplicitlyUnwrappedOptionalTypeSyntax.self) {
+            return optional.wrappedType.trimmedDescription
+        }
+        if let identifier = type.as(IdentifierTypeSyntax.self),
+            identifier.name.text == "Optional",
+            let argument = identifier.genericArgumentClause?.arguments.first
+        {
+            return argument.argument.trimmedDescription
+        }
+        return nil
+    }
+
+    /// Returns the access modifier the generated members need to satisfy the protocols,
+    /// followed by a space, or an empty string.
+    private static func accessModifier(of structDecl: StructDeclSyntax) -> String {
+        for modifier in structDecl.modifiers {
+            switch modifier.name.tokenKind {
+            case .keyword(.public), .keyword(.open):
+                return "public "
+            case .keyword(.package):
+                return "package "
+            default:
+                continue
+            }
+        }
+        return ""
+    }
+}
+
+// MARK: - Errors
+
+/// Errors reported when `@TOMLCodable` can't generate conformances.
+enum TOMLCodableMacroError: Error, CustomStringConvertible {
+    /// The macro is attached to something other than a struct.
+    case notAStruct
+
+    /// A stored property has no type annotation.
+    case missingType(String)
+
+    /// A stored property without a default value has no case in `CodingKeys`.
+    case missingKey(String)
+
+    var description: String {
+        switch self {
+        case .notAStruct:
+            return "@TOMLCodable can only be applied to a struct"
+        case .missingType(let name):
+            return "@TOMLCodable requires a type annotation for '\(name)'"
+        case .missingKey(let name):
+            return "'\(name)' has no case in CodingKeys and no default value"
+        }
+    }
+}
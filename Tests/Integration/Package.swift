@@ -11,19 +11,32 @@ let package = Package(
         .package(path: "../..")
     ],
     targets: [
+        .target(
+            name: "TOMLTestBatch",
+            path: "Sources/TOMLTestBatch"
+        ),
         .executableTarget(
             name: "toml-decoder",
             dependencies: [
-                .product(name: "TOML", package: "swift-toml")
+                .product(name: "TOML", package: "swift-toml"),
+                "TOMLTestBatch",
             ],
             path: "Sources/toml-decoder"
         ),
         .executableTarget(
             name: "toml-encoder",
             dependencies: [
-                .product(name: "TOML", package: "swift-toml")
+                .product(name: "TOML", package: "swift-toml"),
+                "TOMLTestBatch",
             ],
             path: "Sources/toml-encoder"
         ),
+        .executableTarget(
+            name: "toml-array-benchmark",
+            dependencies: [
+                .product(name: "TOML", package: "swift-toml")
+            ],
+            path: "Sources/toml-array-benchmark"
+        ),
     ]
 )
@@ -0,0 +1,113 @@
+import Foundation
+
+/// Runs a CLI's conversion over many documents in a single process.
+///
+/// toml-test launches the CLI once per document,
+/// so most of a run is spent starting the Swift runtime and Foundation.
+/// In batch mode, documents are read from stdin until it closes,
+/// each framed as its length in bytes, in decimal, followed by a newline and the bytes:
+///
+/// ```
+/// 13
+/// name = "test"
+/// ```
+///
+/// Documents are converted on a pool of worker threads,
+/// and results are written to stdout in the same order,
+/// each framed as `ok` or `error`, a space, and its length:
+///
+/// ```
+/// ok 42
+/// {"name":{"type":"string","value":"test"}}
+/// ```
+///
+/// When every result has been written,
+/// a summary of the documents converted and the throughput is written to stderr.
+public enum BatchMode {
+    /// Converts every framed document on stdin, then exits.
+    public static func run(_ convert: (Data) throws -> Data) -> Never {
+        let input = FileHandle.standardInput.readDataToEndOfFile()
+        let documents: [Data]
+        do {
+            documents = try frames(in: input)
+        } catch {
+            FileHandle.standardError.write(Data("Error: \(error)\n".utf8))
+            exit(1)
+        }
+
+        let results = UnsafeMutableBufferPointer<Result<Data, any Error>>.allocate(capacity: documents.count)
+        defer {
+            _ = results.deinitialize()
+            results.deallocate()
+        }
+
+        let start = DispatchTime.now().uptimeNanoseconds
+        DispatchQueue.concurrentPerform(iterations: documents.count) { index in
+            (results.baseAddress! + index).initialize(to: Result { try convert(documents[index]) })
+        }
+        let elapsed = Double(DispatchTime.now().uptimeNanoseconds - start) / 1_000_000_000
+
+        var output = Data()
+        var failures = 0
+        for result in results {
+            let status: String
+            let body: Data
+            switch result {
+            case .success(let data):
+                status = "ok"
+                body = data
+            case .failure(let error):
+                status = "error"
+                body = Data("\(error)".utf8)
+                failures += 1
+            }
+            output.append(Data("\(status) \(body.count)\n".utf8))
+            output.append(body)
+        }
+        FileHandle.standardOutput.write(output)
+
+        let bytes = documents.reduce(0) { $0 + $1.count }
+        let megabytes = Double(bytes) / 1_000_000
+        let summary = String(
+            format: "%d documents (%d ok, %d errors), %.2f MB in %.3f s: %.2f MB/s, %.0f documents/s\n",
+            documents.count,
+            documents.count - failures,
+            failures,
+            megabytes,
+            elapsed,
+            elapsed > 0 ? megabytes / elapsed : 0,
+            elapsed > 0 ? Double(documents.count) / elapsed : 0
+        )
+        FileHandle.standardError.write(Data(summary.utf8))
+        exit(0)
+    }
+
+    /// Splits length-prefixed documents.
+    static func frames(in input: Data) throws -> [Data] {
+        var documents: [Data] = []
+        var index = input.startIndex
+        while index < input.endIndex {
+            guard let newline = input[index...].firstIndex(of: UInt8(ascii: "\n")),
+                let length = Int(String(decoding: input[index ..< newline], as: UTF8.self)),
+                length >= 0, length <= input.endIndex - newline - 1
+            else {
+                throw BatchError.invalidFrame(offset: index - input.startIndex)
+            }
+            let bodyStart = newline + 1
+            documents.append(input[bodyStart ..< bodyStart + length])
+            index = bodyStart + length
+        }
+        return documents
+    }
+}
+
+enum BatchError: Error, CustomStringConvertible {
+    case invalidFrame(offset: Int)
+
+    var description: String {
+        switch self {
+        case .invalidFrame(let offset):
+            return "Invalid batch frame at byte \(offset)"
+        }
+    }
+}
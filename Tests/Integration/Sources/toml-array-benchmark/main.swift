@@ -0,0 +1,75 @@
+import Foundation
+import TOML
+
+/// Times decoding a long array of tables with the serial and concurrent array decoding strategies.
+///
+/// Both strategies decode the same generated document,
+/// which is parsed once per decode, so the difference between them is the time spent in `init(from:)`.
+/// Each strategy is warmed up once, then the best of several runs is reported.
+@main
+struct TOMLArrayBenchmark {
+    struct Catalog: Decodable {
+        let items: [Item]
+    }
+
+    struct Item: Decodable {
+        let id: Int
+        let name: String
+        let price: Double
+        let tags: [String]
+        let dimensions: Dimensions
+    }
+
+    struct Dimensions: Decodable {
+        let width: Double
+        let height: Double
+    }
+
+    static let runs = 5
+
+    static func main() throws {
+        let count = CommandLine.arguments.dropFirst().first.flatMap(Int.init) ?? 100_000
+        var toml = ""
+        for i in 0 ..< count {
+            toml += """
+                [[items]]
+                id = \(i)
+                name = "item \(i)"
+                price = \(Double(i) / 100)
+                tags = ["a", "b"]
+                dimensions = { width = 1.5, height = 2.5 }
+
+
+                """
+        }
+
+        let serial = try measure(.serial, toml)
+        let concurrent = try measure(.concurrent(minimumCount: 1), toml)
+        print("\(count) tables, \(ProcessInfo.processInfo.activeProcessorCount) processors")
+        print("serial:     \(format(serial))")
+        print("concurrent: \(format(concurrent)) (\(String(format: "%.2f", serial / concurrent))x)")
+    }
+
+    /// Returns the shortest time in seconds taken to decode the catalog.
+    static func measure(_ strategy: TOMLDecoder.ArrayDecodingStrategy, _ toml: String) throws -> Double {
+        let decoder = TOMLDecoder()
+        decoder.arrayDecodingStrategy = strategy
+        decoder.limits = .unlimited
+        _ = try decoder.decode(Catalog.self, from: toml)
+
+        let clock = ContinuousClock()
+        var best = Double.infinity
+        for _ in 0 ..< runs {
+            let elapsed = try clock.measure {
+                _ = try decoder.decode(Catalog.self, from: toml)
+            }
+            let components = elapsed.components
+            best = min(best, Double(components.seconds) + Double(components.attoseconds) / 1e18)
+        }
+        return best
+    }
+
+    static func format(_ seconds: Double) -> String {
+        String(format: "%.3f s", seconds)
+    }
+}
@@ -0,0 +1,144 @@
+import SwiftSyntaxMacroExpansion
+import SwiftSyntaxMacrosGenericTestSupport
+import Testing
+
+import TOMLMacros
+
+@Suite("TOMLCodable Macro Tests")
+struct TOMLCodableMacroTests {
+    let macros: [String: MacroSpec] = [
+        "TOMLCodable": MacroSpec(type: TOMLCodableMacro.self, conformances: ["TOMLDecodable", "TOMLEncodable"])
+    ]
+
+    // MARK: - Expansion
+
+    @Test func expandsStoredProperties() {
+        assertMacroExpansion(
+            """
+            @TOMLCodable
+            public struct Server: Codable {
+                public var host: String
+                public var port: Int?
+                var tags: Optional<[String]>
+                let version = 1
+                static let shared = 0
+                var description: String { host }
+            }
+            """,
+            expandedSource: """
+                public struct Server: Codable {
+                    public var host: String
+                    public var port: Int?
+                    var tags: Optional<[String]>
+                    let version = 1
+                    static let shared = 0
+                    var description: String { host }
+                }
+
+                extension Server: TOML.TOMLDecodable, TOML.TOMLEncodable {
+                    public init(toml table: TOML.TOMLDocument.Table) throws {
+                        self.host = try table.decode(String.self, forKey: "host")
+                        self.port = try table.decodeIfPresent(Int.self, forKey: "port")
+                        self.tags = try table.decodeIfPresent([String].self, forKey: "tags")
+                    }
+
+                    public func encode(toml encoder: inout TOML.TOMLTableEncoder) throws {
+                        try encoder.encode(self.host, forKey: "host")
+                        try encoder.encodeIfPresent(self.port, forKey: "port")
+                        try encoder.encodeIfPresent(self.tags, forKey: "tags")
+                    }
+                }
+                """,
+            macroSpecs: macros,
+            failureHandler: { Issue.record("\($0.message)") }
+        )
+    }
+
+    @Test func usesCodingKeys() {
+        assertMacroExpansion(
+            """
+            @TOMLCodable
+            struct Endpoint: Codable {
+                var path: String
+                var timeout: Double
+                var cache: Bool?
+
+                enum CodingKeys: String, CodingKey {
+                    case path
+                    case timeout = "timeout-seconds"
+                }
+            }
+            """,
+            expandedSource: """
+                struct Endpoint: Codable {
+                    var path: String
+                    var timeout: Double
+                    var cache: Bool?
+
+                    enum CodingKeys: String, CodingKey {
+                        case path
+                        case timeout = "timeout-seconds"
+                    }
+                }
+
+                extension Endpoint: TOML.TOMLDecodable, TOML.TOMLEncodable {
+                    init(toml table: TOML.TOMLDocument.Table) throws {
+                        self.path = try table.decode(String.self, forKey: "path")
+                        self.timeout = try table.decode(Double.self, forKey: "timeout-seconds")
+                    }
+
+                    func encode(toml encoder: inout TOML.TOMLTableEncoder) throws {
+                        try encoder.encode(self.path, forKey: "path")
+                        try encoder.encode(self.timeout, forKey: "timeout-seconds")
+                    }
+                }
+                """,
+            macroSpecs: macros,
+            failureHandler: { Issue.record("\($0.message)") }
+        )
+    }
+
+    // MARK: - Diagnostics
+
+    @Test func rejectsNonStructs() {
+        assertMacroExpansion(
+            """
+            @TOMLCodable
+            class Server: Codable {
+                var host = ""
+            }
+            """,
+            expandedSource: """
+                class Server: Codable {
+                    var host = ""
+                }
+                """,
+            diagnostics: [
+                DiagnosticSpec(message: "@TOMLCodable can only be applied to a struct", line: 1, column: 1)
+            ],
+            macroSpecs: macros,
+            failureHandler: { Issue.record("\($0.message)") }
+        )
+    }
+
+    @Test func rejectsPropertiesWithoutTypes() {
+        assertMacroExpansion(
+            """
+            @TOMLCodable
+            struct Server: Codable {
+                var host = ""
+            }
+            """,
+            expandedSource: """
+                struct Server: Codable {
+                    var host = ""
+                }
+                """,
+            diagnostics: [
+                DiagnosticSpec(message: "@TOMLCodable requires a type annotation for 'host'", line: 1, column: 1)
+            ],
+            macroSpecs: macros,
+            failureHandler: { Issue.record("\($0.message)") }
+        )
+    }
+}
@@ -21,4 +21,107 @@ struct CodingKeyTests {
         #expect(key.stringValue == "Index 123")
         #expect(key.intValue == 123)
     }
+
+    @Test func keyConversionCacheConvertsOncePerKey() {
+        final class Counter: @unchecked Sendable {
+            var calls = 0
+        }
+        let counter = Counter()
+        let cache = KeyConversionCache { key in
+            counter.calls += 1
+            return key.uppercased()
+        }
+
+        #expect(cache.convert(TOMLCodingKey(stringValue: "name")) == "NAME")
+        #expect(cache.convert(TOMLCodingKey(stringValue: "name")) == "NAME")
+        #expect(cache.convert(TOMLCodingKey(stringValue: "port")) == "PORT")
+        #expect(counter.calls == 2)
+    }
+
+    @Test func decodingPlanRecordsSlots() throws {
+        let document = try TOMLDocument(string: "alpha = 1\nbeta = 2\ngamma = 3")
+        let table = document.result.root.data.table_value
+        let plan = DecodingPlan(keyDecodingStrategy: .useDefaultKeys)
+
+        let beta = plan.resolve(TOMLCodingKey(stringValue: "beta"), in: table)
+        #expect(beta.name == "beta")
+        #expect(beta.slot == 1)
+        #expect(beta.find(in: table) == 1)
+
+        let missing = plan.resolve(TOMLCodingKey(stringValue: "delta"), in: table)
+        #expect(missing.slot == -1)
+        #expect(missing.find(in: table) == nil)
+
+        #expect(plan.snapshot.keys.sorted() == ["beta", "delta"])
+    }
+
+    @Test func decodingPlanFallsBackWhenSlotMoves() throws {
+        let first = try TOMLDocument(string: "name = 'a'")
+        let second = try TOMLDocument(string: "age = 1\nname = 'b'")
+        let plan = DecodingPlan(keyDecodingStrategy: .useDefaultKeys)
+
+        let name = plan.resolve(TOMLCodingKey(stringValue: "name"), in: first.result.root.data.table_value)
+        #expect(name.slot == 0)
+        #expect(name.find(in: second.result.root.data.table_value) == 1)
+    }
+
+    @Test func decodingPlanMatchesKeyBytes() throws {
+        let document = try TOMLDocument(string: "\"caf\u{E9}\" = 1\n\"cafe\" = 2\n\"\" = 3")
+        let table = document.result.root.data.table_value
+        let plan = DecodingPlan(keyDecodingStrategy: .useDefaultKeys)
+
+        #expect(plan.resolve(TOMLCodingKey(stringValue: "caf\u{E9}"), in: table).find(in: table) != nil)
+        #expect(plan.resolve(TOMLCodingKey(stringValue: "cafe\u{301}"), in: table).find(in: table) == nil)
+        #expect(plan.resolve(TOMLCodingKey(stringValue: ""), in: table).find(in: table) != nil)
+        #expect(plan.resolve(TOMLCodingKey(stringValue: "caf"), in: table).find(in: table) == nil)
+    }
+
+    @Test func decodingPlansLookUpEachKeyTypeOnce() throws {
+        enum Keys: String, CodingKey {
+            case alpha, gamma
+        }
+
+        let document = try TOMLDocument(string: "alpha = 1\nbeta = 2\ngamma = 3")
+        let table = document.result.root.data.table_value
+        let plans = DecodingPlans(keyDecodingStrategy: .useDefaultKeys)
+
+        let plan = plans.plan(for: Keys.self)
+        #expect(plans.plan(for: Keys.self) === plan)
+        #expect(plans.plan(for: TOMLCodingKey.self) !== plan)
+        #expect(plan.entry(forKey: Keys.gamma, in: table).find(in: table) == 2)
+        #expect(plan.entry(forKey: Keys.alpha, in: table).slot == 0)
+    }
+
+    @Test func codingPathMaterializesKeys() {
+        let parent = CodingPath.root.appending(TOMLCodingKey(stringValue: "servers"))
+        let first = parent.appending(index: 0)
+        let second = parent.appending(index: 1).appending(TOMLCodingKey(stringValue: "host"))
+
+        #expect(CodingPath.root.keys.isEmpty)
+        #expect(first.keys.map(\.stringValue) == ["servers", "Index 0"])
+        #expect(first.keys.map(\.intValue) == [nil, 0])
+        #expect(second.keys.map(\.stringValue) == ["servers", "Index 1", "host"])
+    }
+
+    @Test func rootKeyRecorderDetectsMisses() {
+        let full = RootKeyRecorder(selectedKeys: nil)
+        full.record("name")
+        #expect(!full.missed)
+
+        let plan = RootKeyPlan()
+        #expect(plan.selectedKeys == nil)
+        plan.update(with: full)
+        #expect(plan.selectedKeys == ["name"])
+
+        let selected = RootKeyRecorder(selectedKeys: ["name"])
+        selected.record("name")
+        #expect(!selected.missed)
+        selected.record("port")
+        #expect(selected.missed)
+
+        let all = RootKeyRecorder(selectedKeys: nil)
+        all.requireAllKeys()
+        plan.update(with: all)
+        #expect(plan.selectedKeys == nil)
+    }
 }
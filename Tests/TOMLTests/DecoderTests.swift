@@ -354,6 +354,27 @@ struct TOMLDecoderTests {
         #expect(config.timestamp.timeIntervalSince1970 > 0)
     }
 
+    @Test func decodeOffsetDateTimeEpoch() throws {
+        let toml = """
+            utc = 1979-05-27T07:32:00Z
+            offset = 1979-05-27T00:32:00.5-07:00
+            early = 0001-01-01T00:00:00Z
+            """
+
+        struct Config: Codable {
+            let utc: Date
+            let offset: Date
+            let early: Date
+        }
+
+        let decoder = TOMLDecoder()
+        let config = try decoder.decode(Config.self, from: toml)
+
+        #expect(config.utc.timeIntervalSince1970 == 296_638_320)
+        #expect(config.offset.timeIntervalSince1970 == 296_638_320.5)
+        #expect(config.early.timeIntervalSince1970 == -62_135_596_800)
+    }
+
     @Test func decodeLocalDateTime() throws {
         let toml = """
             datetime = 2024-06-15T10:30:00
@@ -518,6 +539,56 @@ struct TOMLDecoderTests {
         #expect(config.userName == "john")
     }
 
+    // MARK: - Array Decoding Strategy
+
+    @Test func decodeConcurrentArrayOfTables() throws {
+        struct Item: Codable, Equatable {
+            let id: Int
+            let name: String
+            let tags: [String]
+        }
+
+        struct Catalog: Codable, Equatable {
+            let items: [Item]
+        }
+
+        var toml = ""
+        for i in 0 ..< 5000 {
+            toml += "[[items]]\nid = \(i)\nname = \"item \(i)\"\ntags = [\"a\", \"b\"]\n"
+        }
+
+        let serial = try TOMLDecoder().decode(Catalog.self, from: toml)
+
+        let decoder = TOMLDecoder()
+        decoder.arrayDecodingStrategy = .concurrent(minimumCount: 100)
+        let concurrent = try decoder.decode(Catalog.self, from: toml)
+
+        #expect(concurrent.items.count == 5000)
+        #expect(concurrent.items.map(\.id) == Array(0 ..< 5000))
+        #expect(concurrent == serial)
+    }
+
+    @Test func decodeConcurrentArrayReportsFirstError() throws {
+        struct Item: Codable {
+            let id: Int
+        }
+
+        var toml = ""
+        for i in 0 ..< 1000 {
+            toml += i == 300 || i == 700 ? "[[items]]\nid = \"bad\"\n" : "[[items]]\nid = \(i)\n"
+        }
+
+        let decoder = TOMLDecoder()
+        decoder.arrayDecodingStrategy = .concurrent(minimumCount: 10)
+
+        do {
+            _ = try decoder.decode([String: [Item]].self, from: toml)
+            Issue.record("Expected decoding to fail")
+        } catch DecodingError.typeMismatch(_, let context) {
+            #expect(context.codingPath.map(\.stringValue) == ["items", "Index 300", "id"])
+        }
+    }
+
     // MARK: - Optional Values
 
     @Test func decodeOptionalPresent() throws {
@@ -582,6 +653,241 @@ struct TOMLDecoderTests {
         #expect(config["outer"]?["inner"] == 42)
     }
 
+    // MARK: - Root Key Skipping
+
+    @Test func decodeNarrowTypeRepeatedly() throws {
+        struct Narrow: Codable, Equatable {
+            let name: String
+            let server: Server
+
+            struct Server: Codable, Equatable {
+                let port: Int
+            }
+        }
+
+        let decoder = TOMLDecoder()
+        decoder.skipsUnreadRootKeys = true
+        for i in 0 ..< 3 {
+            let toml = """
+                name = "app \(i)"
+                unrelated = [1, 2, 3]
+
+                [server]
+                port = \(8000 + i)
+
+                [other_team]
+                settings = { deep = { deeper = true } }
+                """
+            let narrow = try decoder.decode(Narrow.self, from: toml)
+            #expect(narrow == Narrow(name: "app \(i)", server: .init(port: 8000 + i)))
+        }
+    }
+
+    @Test func decodeTypeReadingNewRootKey() throws {
+        struct Conditional: Decodable {
+            let mode: String
+            let extra: Int?
+
+            enum CodingKeys: String, CodingKey {
+                case mode, extra
+            }
+
+            init(from decoder: any Decoder) throws {
+                let container = try decoder.container(keyedBy: CodingKeys.self)
+                mode = try container.decode(String.self, forKey: .mode)
+                extra = mode == "full" ? try container.decode(Int.self, forKey: .extra) : nil
+            }
+        }
+
+        let decoder = TOMLDecoder()
+        decoder.skipsUnreadRootKeys = true
+        let basic = try decoder.decode(Conditional.self, from: "mode = \"basic\"\nextra = 1")
+        let full = try decoder.decode(Conditional.self, from: "mode = \"full\"\nextra = 2")
+
+        #expect(basic.extra == nil)
+        #expect(full.extra == 2)
+    }
+
+    @Test func decodeDictionaryAfterSkipping() throws {
+        let decoder = TOMLDecoder()
+        decoder.skipsUnreadRootKeys = true
+        _ = try decoder.decode([String: Int].self, from: "a = 1")
+        let dictionary = try decoder.decode([String: Int].self, from: "a = 1\nb = 2")
+
+        #expect(dictionary == ["a": 1, "b": 2])
+    }
+
+    @Test func decodeSkippingStillChecksLimits() throws {
+        struct Narrow: Decodable {
+            let name: String
+        }
+
+        let decoder = TOMLDecoder()
+        decoder.skipsUnreadRootKeys = true
+        decoder.limits.maxDepth = 3
+        _ = try decoder.decode(Narrow.self, from: "name = \"app\"\n[other]\nx = 1")
+
+        let deep = "name = \"app\"\n[other]\nx = { y = { z = 1 } }"
+        for _ in 0 ..< 2 {
+            #expect(throws: TOMLDecodingError.self) {
+                try decoder.decode(Narrow.self, from: deep)
+            }
+        }
+    }
+
+    @Test func decodeSkippingCountsCharactersInSkippedStrings() throws {
+        struct Narrow: Decodable {
+            let name: String
+        }
+
+        let decoder = TOMLDecoder()
+        decoder.skipsUnreadRootKeys = true
+        decoder.limits.maxStringLength = 3
+        _ = try decoder.decode(Narrow.self, from: "name = \"app\"")
+
+        // Three characters, but six Unicode scalars.
+        let combining = "name = \"app\"\nother = \"e\u{301}e\u{301}e\u{301}\""
+        #expect(try decoder.decode(Narrow.self, from: combining).name == "app")
+        #expect(throws: TOMLDecodingError.self) {
+            try decoder.decode(Narrow.self, from: "name = \"app\"\nother = \"abcd\"")
+        }
+    }
+
+    @Test func decodeWithoutSkippingReadsEachTypeOnce() throws {
+        final class Counter: @unchecked Sendable {
+            var count = 0
+        }
+        struct Conditional: Decodable {
+            enum CodingKeys: String, CodingKey {
+                case mode, extra
+            }
+
+            init(from decoder: any Decoder) throws {
+                (decoder.userInfo[CodingUserInfoKey(rawValue: "counter")!] as? Counter)?.count += 1
+                let container = try decoder.container(keyedBy: CodingKeys.self)
+                if try container.decode(String.self, forKey: .mode) == "full" {
+                    _ = try container.decode(Int.self, forKey: .extra)
+                }
+            }
+        }
+
+        let counter = Counter()
+        let decoder = TOMLDecoder()
+        decoder.userInfo = [CodingUserInfoKey(rawValue: "counter")!: counter]
+        _ = try decoder.decode(Conditional.self, from: "mode = \"basic\"\nextra = 1")
+        _ = try decoder.decode(Conditional.self, from: "mode = \"full\"\nextra = 2")
+
+        #expect(counter.count == 2)
+    }
+
+    // MARK: - Dynamic Decoding
+
+    @Test func decodeValueKeepsTOMLTypes() throws {
+        let toml = """
+            name = "test"
+            count = 3
+            ratio = 0.5
+            enabled = true
+            date = 2024-01-15
+            time = 09:30:00
+            local = 2024-01-15T09:30:00
+            [server]
+            ports = [8080, 8081]
+            """
+
+        let value = try TOMLDecoder().decodeValue(from: toml)
+        guard case .table(let table) = value else {
+            Issue.record("Expected a table, got \(value)")
+            return
+        }
+
+        #expect(Set(table.keys) == ["name", "count", "ratio", "enabled", "date", "time", "local", "server"])
+        #expect(table["count"] == .integer(3))
+        #expect(table["ratio"] == .float(0.5))
+        #expect(table["enabled"] == .boolean(true))
+        #expect(table["date"] == .localDate(LocalDate(year: 2024, month: 1, day: 15)))
+        #expect(table["time"] == .localTime(LocalTime(hour: 9, minute: 30, second: 0)))
+        let local = LocalDateTime(year: 2024, month: 1, day: 15, hour: 9, minute: 30, second: 0)
+        #expect(table["local"] == .localDateTime(local))
+        #expect(table["server"] == .table(["ports": .array([.integer(8080), .integer(8081)])]))
+    }
+
+    @Test func decodeValueKeepsDocumentOrder() throws {
+        let toml = """
+            zeta = 1
+            alpha = { y = 1, b = 2 }
+            [mid]
+            [beta]
+            """
+
+        let value = try TOMLDecoder().decodeValue(from: toml)
+        guard case .table(let table) = value, case .table(let alpha)? = table["alpha"] else {
+            Issue.record("Expected nested tables, got \(value)")
+            return
+        }
+        #expect(table.keys == ["zeta", "alpha", "mid", "beta"])
+        #expect(alpha.keys == ["y", "b"])
+    }
+
+    @Test func decodeTOMLValueFields() throws {
+        struct Plugin: Decodable {
+            let name: String
+            let settings: TOMLValue
+            let extras: [TOMLValue]
+        }
+
+        let decoder = TOMLDecoder()
+        let toml = "name = \"lint\"\nextras = [1, \"two\"]\n[settings]\nstrict = true"
+        let plugin = try decoder.decode(Plugin.self, from: toml)
+        let whole = try decoder.decode(TOMLValue.self, from: toml)
+
+        #expect(plugin.settings == .table(["strict": .boolean(true)]))
+        #expect(plugin.extras == [.integer(1), .string("two")])
+        #expect(whole == (try decoder.decodeValue(from: toml)))
+        // Decoding the root again goes through the root key plan.
+        #expect(try decoder.decode(TOMLValue.self, from: toml) == whole)
+    }
+
+    @Test func decodeTOMLValueFromOtherDecoders() throws {
+        let json = Data(#"{"name": "test", "tags": ["a", 1, true]}"#.utf8)
+        let value = try JSONDecoder().decode(TOMLValue.self, from: json)
+
+        guard case .table(let table) = value else {
+            Issue.record("Expected a table, got \(value)")
+            return
+        }
+        #expect(table["name"] == .string("test"))
+        #expect(table["tags"] == .array([.string("a"), .integer(1), .boolean(true)]))
+    }
+
+    // MARK: - Tagged JSON
+
+    @Test func taggedJSON() throws {
+        let toml = #"""
+            name = "a \"b\"\n"
+            ratio = 3.0
+            when = 1979-05-27T07:32:00-08:00
+            time = 09:30:00.5
+            [server]
+            ports = [8080, nan]
+            """#
+
+        let json = try TOMLDecoder().taggedJSON(from: Data(toml.utf8))
+        let expected = #"""
+            {"name":{"type":"string","value":"a \"b\"\n"},"ratio":{"type":"float","value":"3.0"},\#
+            "server":{"ports":[{"type":"integer","value":"8080"},{"type":"float","value":"nan"}]},\#
+            "time":{"type":"time-local","value":"09:30:00.500"},\#
+            "when":{"type":"datetime","value":"1979-05-27T15:32:00.000Z"}}
+            """#
+        #expect(String(decoding: json, as: UTF8.self) == expected)
+    }
+
+    @Test func taggedJSONInvalidTOML() {
+        #expect(throws: TOMLDecodingError.self) {
+            try TOMLDecoder().taggedJSON(from: Data("key = ".utf8))
+        }
+    }
+
     // MARK: - Decode from Data
 
     @Test func decodeFromData() throws {
@@ -598,6 +904,88 @@ struct TOMLDecoderTests {
         #expect(config.name == "test")
     }
 
+    @Test func decodeFromBytes() throws {
+        let bytes = Array("name = \"test\"".utf8)
+
+        struct Config: Codable {
+            let name: String
+        }
+
+        let decoder = TOMLDecoder()
+        let config = try decoder.decode(Config.self, from: bytes)
+        let fromBuffer = try bytes.withUnsafeBytes { buffer in
+            try decoder.decode(Config.self, from: buffer)
+        }
+
+        #expect(config.name == "test")
+        #expect(fromBuffer.name == "test")
+    }
+
+    @Test func decodeFromBytesExceedingMaxInputSize() throws {
+        let decoder = TOMLDecoder()
+        decoder.limits.maxInputSize = 4
+        let bytes = Array("name = \"test\"".utf8)
+
+        #expect(throws: TOMLDecodingError.self) {
+            try decoder.decode([String: String].self, from: bytes)
+        }
+    }
+
+    // MARK: - Decode from AsyncSequence
+
+    @Test func decodeFromAsyncBytes() async throws {
+        let stream = AsyncStream<UInt8> { continuation in
+            for byte in "name = \"test\"\nport = 8080".utf8 {
+                continuation.yield(byte)
+            }
+            continuation.finish()
+        }
+
+        struct Config: Codable {
+            let name: String
+            let port: Int
+        }
+
+        let config = try await TOMLDecoder().decode(Config.self, from: stream)
+
+        #expect(config.name == "test")
+        #expect(config.port == 8080)
+    }
+
+    @Test func decodeFromAsyncChunks() async throws {
+        let stream = AsyncStream<Data> { continuation in
+            continuation.yield(Data("name = \"te".utf8))
+            continuation.yield(Data("st\"\nport = 80".utf8))
+            continuation.yield(Data("80".utf8))
+            continuation.finish()
+        }
+
+        struct Config: Codable {
+            let name: String
+            let port: Int
+        }
+
+        let config = try await TOMLDecoder().decode(Config.self, from: stream)
+
+        #expect(config.name == "test")
+        #expect(config.port == 8080)
+    }
+
+    @Test func decodeFromAsyncChunksExceedingMaxInputSize() async throws {
+        let stream = AsyncStream<[UInt8]> { continuation in
+            continuation.yield(Array("name = ".utf8))
+            continuation.yield(Array("\"test\"".utf8))
+            continuation.finish()
+        }
+
+        let decoder = TOMLDecoder()
+        decoder.limits.maxInputSize = 10
+
+        await #expect(throws: TOMLDecodingError.self) {
+            try await decoder.decode([String: String].self, from: stream)
+        }
+    }
+
     // MARK: - User Info
 
     @Test func decoderUserInfo() throws {
@@ -840,6 +1228,29 @@ struct TOMLDecoderTests {
         }
     }
 
+    @Test func decoderReportsCodingPath() throws {
+        struct Leaf: Decodable {
+            let path: [String]
+
+            init(from decoder: any Decoder) throws {
+                path = decoder.codingPath.map(\.stringValue)
+            }
+        }
+
+        struct Config: Decodable {
+            let groups: [[String: [Leaf]]]
+        }
+
+        let toml = """
+            [[groups]]
+            leaves = [{}, {}]
+            """
+
+        let config = try TOMLDecoder().decode(Config.self, from: toml)
+
+        #expect(config.groups[0]["leaves"]?[1].path == ["groups", "Index 0", "leaves", "Index 1"])
+    }
+
     // MARK: - Error Descriptions
 
     @Test func errorDescriptionInvalidSyntax() {
@@ -966,6 +1377,39 @@ struct TOMLDecoderTests {
         #expect(config.fruit.apple.taste == "sweet")
     }
 
+    // MARK: - Quoted Keys
+
+    @Test func decodeQuotedKeys() throws {
+        let toml = """
+            "zeta key" = 1
+            "é" = 2
+            alpha = 3
+            "" = 4
+            """
+
+        struct Config: Codable {
+            let zeta: Int
+            let accented: Int
+            let alpha: Int
+            let empty: Int
+
+            enum CodingKeys: String, CodingKey {
+                case zeta = "zeta key"
+                case accented = "é"
+                case alpha
+                case empty = ""
+            }
+        }
+
+        let decoder = TOMLDecoder()
+        let config = try decoder.decode(Config.self, from: toml)
+
+        #expect(config.zeta == 1)
+        #expect(config.accented == 2)
+        #expect(config.alpha == 3)
+        #expect(config.empty == 4)
+    }
+
     // MARK: - Boolean Values
 
     @Test func decodeBooleanValues() throws {
@@ -988,6 +1432,48 @@ struct TOMLDecoderTests {
 
     // MARK: - Array Decoding Edge Cases
 
+    @Test func decodePrimitiveArrays() throws {
+        let toml = """
+            ints = [1, 2, 3]
+            wide = [-9223372036854775808, 9223372036854775807]
+            doubles = [1.5, 2, -3.25]
+            strings = ["a", "", "c"]
+            bools = [true, false]
+            empty = []
+            """
+
+        struct Config: Codable {
+            let ints: [Int]
+            let wide: [Int64]
+            let doubles: [Double]
+            let strings: [String]
+            let bools: [Bool]
+            let empty: [Int]
+        }
+
+        let config = try TOMLDecoder().decode(Config.self, from: toml)
+
+        #expect(config.ints == [1, 2, 3])
+        #expect(config.wide == [.min, .max])
+        #expect(config.doubles == [1.5, 2.0, -3.25])
+        #expect(config.strings == ["a", "", "c"])
+        #expect(config.bools == [true, false])
+        #expect(config.empty.isEmpty)
+    }
+
+    @Test func decodePrimitiveArrayWithMismatchedElement() throws {
+        let toml = """
+            values = [1, 2, "three"]
+            """
+
+        do {
+            _ = try TOMLDecoder().decode([String: [Int]].self, from: toml)
+            Issue.record("Expected decoding to fail")
+        } catch DecodingError.typeMismatch(_, let context) {
+            #expect(context.codingPath.map(\.stringValue) == ["values", "Index 2"])
+        }
+    }
+
     @Test func decodeArrayOfDates() throws {
         let toml = """
             dates = [2024-01-01, 2024-06-15, 2024-12-31]
@@ -0,0 +1,211 @@
+import Testing
+import Foundation
+
+import TOML
+
+@Suite("TOMLDocument Tests")
+struct DocumentTests {
+    let toml = """
+        title = "Example"
+        enabled = true
+
+        [server]
+        host = "localhost"
+        port = 8080
+        ratio = 0.5
+
+        [[servers]]
+        name = "alpha"
+
+        [[servers]]
+        name = "beta"
+        """
+
+    // MARK: - Lookup
+
+    @Test func topLevelScalars() throws {
+        let document = try TOMLDocument(string: toml)
+
+        #expect(document["title"]?.string == "Example")
+        #expect(document["enabled"]?.boolean == true)
+        #expect(document["missing"] == nil)
+    }
+
+    @Test func nestedTables() throws {
+        let document = try TOMLDocument(string: toml)
+
+        #expect(document["server"]?["host"]?.string == "localhost")
+        #expect(document["server"]?["port"]?.integer == 8080)
+        #expect(document["server"]?["ratio"]?.float == 0.5)
+        #expect(document["server"]?["missing"] == nil)
+    }
+
+    @Test func arrays() throws {
+        let document = try TOMLDocument(string: toml)
+        let servers = try #require(document["servers"]?.array)
+
+        #expect(servers.count == 2)
+        #expect(servers.map { $0["name"]?.string } == ["alpha", "beta"])
+        #expect(document["servers"]?[1]?["name"]?.string == "beta")
+        #expect(document["servers"]?[2] == nil)
+    }
+
+    @Test func mismatchedTypesReturnNil() throws {
+        let document = try TOMLDocument(string: toml)
+
+        #expect(document["title"]?.integer == nil)
+        #expect(document["title"]?.table == nil)
+        #expect(document["server"]?.array == nil)
+        #expect(document["title"]?["key"] == nil)
+    }
+
+    // MARK: - Iteration
+
+    @Test func tableIteration() throws {
+        let document = try TOMLDocument(string: toml)
+        let server = try #require(document["server"]?.table)
+
+        #expect(server.count == 3)
+        #expect(server.keys == ["host", "port", "ratio"])
+        #expect(document.root.keys.sorted() == ["enabled", "server", "servers", "title"])
+    }
+
+    @Test func tableIterationFollowsDocumentOrder() throws {
+        let toml = """
+            zeta = 1
+            alpha = 2
+            [mid]
+            b = 1
+            a = 2
+            """
+        let document = try TOMLDocument(string: toml)
+
+        #expect(document.root.keys == ["zeta", "alpha", "mid"])
+        #expect(document.root.map { $0.value.integer } == [1, 2, nil])
+        #expect(document["mid"]?.table?.keys == ["b", "a"])
+
+        guard case .table(let table) = try TOMLDecoder().decodeValue(from: toml) else {
+            Issue.record("Expected a table")
+            return
+        }
+        #expect(table.keys == document.root.keys)
+    }
+
+    // MARK: - Dates
+
+    @Test func dateTypes() throws {
+        let document = try TOMLDocument(string: """
+            odt = 1979-05-27T07:32:00Z
+            ldt = 1979-05-27T07:32:00
+            ld = 1979-05-27
+            lt = 07:32:00
+            """)
+
+        #expect(document["odt"]?.offsetDateTime == Date(timeIntervalSince1970: 296_638_320))
+        #expect(document["odt"]?.localDateTime == nil)
+        #expect(
+            document["ldt"]?.localDateTime
+                == LocalDateTime(year: 1979, month: 5, day: 27, hour: 7, minute: 32, second: 0)
+        )
+        #expect(document["ldt"]?.offsetDateTime == nil)
+        #expect(document["ld"]?.localDate == LocalDate(year: 1979, month: 5, day: 27))
+        #expect(document["lt"]?.localTime == LocalTime(hour: 7, minute: 32, second: 0))
+    }
+
+    // MARK: - Materialization
+
+    @Test func materializedValue() throws {
+        let document = try TOMLDocument(string: toml)
+
+        #expect(document["server"]?["port"]?.value == .integer(8080))
+        #expect(
+            document["servers"]?.value
+                == .array([
+                    .table(["name": .string("alpha")]),
+                    .table(["name": .string("beta")]),
+                ])
+        )
+    }
+
+    @Test func nodesOutliveDocument() throws {
+        var document: TOMLDocument? = try TOMLDocument(bytes: Array(toml.utf8))
+        let host = document?["server"]?["host"]
+        document = nil
+
+        #expect(host?.string == "localhost")
+    }
+
+    // MARK: - Formatting
+
+    @Test func formatAsJSONAndYAML() throws {
+        let document = try TOMLDocument(string: "title = \"x\"\n[server]\nport = 8080")
+
+        let json = try document.data(as: .json)
+        #expect(
+            String(decoding: json, as: UTF8.self) == """
+                {
+                    "server" : {
+                        "port" : 8080
+                    },
+                    "title" : "x"
+                }
+                """
+        )
+
+        let yaml = String(decoding: try document.data(as: .yaml), as: UTF8.self)
+        #expect(yaml.contains("  port: 8080\n"))
+        #expect(yaml.hasSuffix("title: x"))
+
+        let toml = try document.data(as: .toml)
+        #expect(try TOMLDocument(bytes: toml).value == document.value)
+    }
+
+    @Test func formatPassesSinkErrors() throws {
+        final class FailingSink: TOMLOutputSink {
+            func write(_ bytes: UnsafeRawBufferPointer) throws {
+                throw CocoaError(.fileWriteOutOfSpace)
+            }
+        }
+
+        let document = try TOMLDocument(string: toml)
+        #expect(throws: CocoaError.self) {
+            try document.write(as: .json, to: FailingSink())
+        }
+    }
+
+    // MARK: - Limits
+
+    @Test func documentChecksLimits() throws {
+        var limits = TOMLDecoder.DecodingLimits.default
+        limits.maxInputSize = 4
+        #expect(throws: TOMLDecodingError.self) {
+            try TOMLDocument(string: toml, limits: limits)
+        }
+        #expect(throws: TOMLDecodingError.self) {
+            try TOMLDocument(bytes: Array(toml.utf8), limits: limits)
+        }
+
+        limits = .default
+        limits.maxDepth = 2
+        #expect(throws: TOMLDecodingError.self) {
+            try TOMLDocument(string: "a = { b = { c = 1 } }", limits: limits)
+        }
+
+        limits = .default
+        limits.maxArrayLength = 1
+        #expect(throws: TOMLDecodingError.self) {
+            try TOMLDocument(bytes: Array(toml.utf8), limits: limits)
+        }
+
+        let document = try TOMLDocument(string: "a = { b = { c = 1 } }", limits: .unlimited)
+        #expect(document["a"]?["b"]?["c"]?.integer == 1)
+    }
+
+    // MARK: - Errors
+
+    @Test func invalidSyntax() {
+        #expect(throws: TOMLDecodingError.self) {
+            try TOMLDocument(string: "key = ")
+        }
+    }
+}
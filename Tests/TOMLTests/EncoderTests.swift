@@ -96,6 +96,17 @@ struct EncoderTests {
         #expect(toml.contains("nan = nan"))
     }
 
+    @Test func encodeFloatFormatting() throws {
+        let values: [String: Double] = ["whole": 42, "negative": -3, "zero": -0.0, "fraction": 0.1, "large": 1e300]
+        let toml = try TOMLEncoder().encodeToString(values)
+
+        #expect(toml.contains("whole = 42.0\n"))
+        #expect(toml.contains("negative = -3.0\n"))
+        #expect(toml.contains("zero = -0.0\n"))
+        #expect(toml.contains("fraction = 0.1\n"))
+        #expect(toml.contains("large = 1e+300\n"))
+    }
+
     // MARK: - String Escaping
 
     @Test func encodeStringEscaping() throws {
@@ -137,6 +148,20 @@ struct EncoderTests {
         #expect(toml.contains("\\u0007"))
     }
 
+    @Test func encodeEscapesAcrossLongRuns() throws {
+        struct Text: Codable, Equatable {
+            let body: String
+        }
+
+        let text = Text(body: "caf\u{E9} plain text run\u{1F}\u{7F} and \"quotes\" \u{1F600}\\end\r\n")
+        let toml = try TOMLEncoder().encodeToString(text)
+
+        #expect(
+            toml == "body = \"caf\u{E9} plain text run\\u001F\\u007F and \\\"quotes\\\" \u{1F600}\\\\end\\r\\n\"\n"
+        )
+        #expect(try TOMLDecoder().decode(Text.self, from: toml) == text)
+    }
+
     @Test func encodeSpecialKeyNames() throws {
         let dict = ["key with spaces": "value", "key.with.dots": "value2"]
         let encoder = TOMLEncoder()
@@ -350,6 +375,39 @@ struct EncoderTests {
         #expect(toml.contains("10:30:45"))
     }
 
+    @Test func encodeDateTimeFormatting() throws {
+        struct Config: Codable {
+            let before1970: Date
+            let rounded: Date
+            let dateTime: LocalDateTime
+            let date: LocalDate
+            let time: LocalTime
+        }
+
+        let config = Config(
+            before1970: Date(timeIntervalSince1970: -86_400 * 365 - 0.25),
+            rounded: Date(timeIntervalSince1970: 951_782_400.0004),
+            dateTime: LocalDateTime(
+                year: 987,
+                month: 1,
+                day: 2,
+                hour: 3,
+                minute: 4,
+                second: 5,
+                nanosecond: 120_000_000
+            ),
+            date: LocalDate(year: 2024, month: 2, day: 29),
+            time: LocalTime(hour: 23, minute: 59, second: 59, nanosecond: 1)
+        )
+        let toml = try TOMLEncoder().encodeToString(config)
+
+        #expect(toml.contains("before1970 = 1968-12-31T23:59:59.750Z\n"))
+        #expect(toml.contains("rounded = 2000-02-29T00:00:00.000Z\n"))
+        #expect(toml.contains("dateTime = 0987-01-02T03:04:05.12\n"))
+        #expect(toml.contains("date = 2024-02-29\n"))
+        #expect(toml.contains("time = 23:59:59.000000001\n"))
+    }
+
     // MARK: - Local Date/Time Types
 
     @Test func encodeLocalDateTime() throws {
@@ -440,6 +498,20 @@ struct EncoderTests {
         #expect(lines[2].hasPrefix("zebra"))
     }
 
+    @Test func unsortedKeysFollowEncodingOrder() throws {
+        struct Config: Codable {
+            let zebra: String
+            let alpha: String
+            let middle: String
+        }
+
+        let config = Config(zebra: "z", alpha: "a", middle: "m")
+        let toml = try TOMLEncoder().encodeToString(config)
+
+        let lines = toml.components(separatedBy: "\n").filter { !$0.isEmpty }
+        #expect(lines == [#"zebra = "z""#, #"alpha = "a""#, #"middle = "m""#])
+    }
+
     @Test func prettyPrintedOutput() throws {
         struct Config: Codable {
             let name: String
@@ -480,6 +552,366 @@ struct EncoderTests {
         #expect(String(data: data, encoding: .utf8)?.contains("name = \"test\"") == true)
     }
 
+    // MARK: - Encode to Sink
+
+    struct Catalog: Codable, Equatable, Sendable {
+        struct Item: Codable, Equatable, Sendable {
+            let id: Int
+            let name: String
+        }
+        let title: String
+        let items: [Item]
+    }
+
+    static let catalog = Catalog(
+        title: "catalog",
+        items: (0 ..< 5000).map { Catalog.Item(id: $0, name: "item \($0)") }
+    )
+
+    @Test func encodeToBytesSink() throws {
+        let encoder = TOMLEncoder()
+        let sink = TOMLBytesSink()
+        try encoder.encode(Self.catalog, to: sink)
+
+        #expect(sink.bytes.count > 64 * 1024)
+        #expect(String(decoding: sink.bytes, as: UTF8.self) == (try encoder.encodeToString(Self.catalog)))
+    }
+
+    @Test func encodeToFileSink() throws {
+        let url = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString + ".toml")
+        #expect(FileManager.default.createFile(atPath: url.path, contents: nil))
+        defer { try? FileManager.default.removeItem(at: url) }
+
+        let fileHandle = try FileHandle(forWritingTo: url)
+        try TOMLEncoder().encode(Self.catalog, to: TOMLFileSink(fileHandle: fileHandle))
+        fileHandle.closeFile()
+
+        let decoded = try TOMLDecoder().decode(Catalog.self, from: Data(contentsOf: url))
+        #expect(decoded == Self.catalog)
+    }
+
+    @Test func encodeToAsyncStreamSink() async throws {
+        let (chunks, sink) = TOMLAsyncStreamSink.makeStream()
+        try TOMLEncoder().encode(Self.catalog, to: sink)
+        sink.finish()
+
+        var bytes: [UInt8] = []
+        var chunkCount = 0
+        for await chunk in chunks {
+            bytes += chunk
+            chunkCount += 1
+        }
+
+        #expect(chunkCount > 1)
+        #expect(try TOMLDecoder().decode(Catalog.self, from: bytes) == Self.catalog)
+    }
+
+    @Test func concurrentArrayEncodingMatchesSerial() throws {
+        let encoder = TOMLEncoder()
+        let serial = try encoder.encodeToString(Self.catalog)
+
+        encoder.arrayEncodingStrategy = .concurrent(minimumCount: 100)
+        #expect(try encoder.encodeToString(Self.catalog) == serial)
+
+        let sink = TOMLBytesSink()
+        try encoder.encode(Self.catalog, to: sink)
+        #expect(String(decoding: sink.bytes, as: UTF8.self) == serial)
+    }
+
+    // MARK: - Serialization Backend
+
+    @Test func nativeBackendRoundTrips() throws {
+        struct Config: Codable, Equatable {
+            struct Server: Codable, Equatable {
+                let host: String
+                let ports: [Int]
+            }
+            struct Item: Codable, Equatable {
+                let id: Int
+                let ratio: Double
+            }
+            let title: String
+            let enabled: Bool
+            let started: Date
+            let date: LocalDate
+            let time: LocalTime
+            let server: Server
+            let items: [Item]
+        }
+
+        let config = Config(
+            title: "Caf\u{E9} \"quoted\"\nline",
+            enabled: true,
+            started: Date(timeIntervalSince1970: 296_638_320.5),
+            date: LocalDate(year: 1979, month: 5, day: 27),
+            time: LocalTime(hour: 7, minute: 32, second: 0, nanosecond: 999_000_000),
+            server: .init(host: "localhost", ports: [8080, 8081]),
+            items: [.init(id: 1, ratio: 0.5), .init(id: 2, ratio: 1.0)]
+        )
+
+        let encoder = TOMLEncoder()
+        encoder.serializationBackend = .native
+        let data = try encoder.encode(config)
+        let decoded = try TOMLDecoder().decode(Config.self, from: data)
+
+        #expect(decoded == config)
+        #expect(try encoder.encodeToString(config) == String(decoding: data, as: UTF8.self))
+    }
+
+    @Test func nativeBackendWritesTables() throws {
+        struct Config: Codable {
+            struct Server: Codable {
+                let host: String
+            }
+            struct Item: Codable {
+                let id: Int
+            }
+            let server: Server
+            let items: [Item]
+            let name: String
+        }
+
+        let encoder = TOMLEncoder()
+        encoder.serializationBackend = .native
+        let toml = try encoder.encodeToString(
+            Config(server: .init(host: "a"), items: [.init(id: 1), .init(id: 2)], name: "x")
+        )
+
+        #expect(toml.hasPrefix("name = \"x\"\n"))
+        #expect(toml.contains("[server]\nhost = \"a\"\n"))
+        #expect(toml.contains("[[items]]\nid = 1\n\n[[items]]\nid = 2"))
+    }
+
+    @Test func nativeBackendRejectsOutOfRangeDates() {
+        struct Config: Codable {
+            let date: LocalDate
+        }
+
+        let encoder = TOMLEncoder()
+        encoder.serializationBackend = .native
+
+        #expect(throws: TOMLEncodingError.self) {
+            try encoder.encode(Config(date: LocalDate(year: 2024, month: 13, day: 1)))
+        }
+    }
+
+    @Test func nativeBackendRejectsUnrepresentableInstants() {
+        struct Event: Codable {
+            let at: Date
+        }
+        struct Config: Codable {
+            let events: [Event]
+        }
+
+        let encoder = TOMLEncoder()
+        encoder.serializationBackend = .native
+
+        for interval in [Double.nan, .infinity, -.infinity, 1e300, 253_402_300_800] {
+            let config = Config(events: [Event(at: Date()), Event(at: Date(timeIntervalSince1970: interval))])
+            do {
+                _ = try encoder.encode(config)
+                Issue.record("Expected an error for \(interval)")
+            } catch TOMLEncodingError.invalidValue(_, let codingPath) {
+                #expect(codingPath.map(\.stringValue) == ["events", "Index 1", "at"])
+            } catch {
+                Issue.record("Unexpected error: \(error)")
+            }
+        }
+    }
+
+    @Test func swiftBackendRejectsUnrepresentableDates() {
+        struct Event: Codable {
+            let at: Date
+        }
+        struct Config: Codable {
+            let events: [Event]
+        }
+
+        for strategy in [TOMLEncoder.DateEncodingStrategy.iso8601, .localDateTime, .localDate] {
+            let encoder = TOMLEncoder()
+            encoder.dateEncodingStrategy = strategy
+
+            for interval in [Double.nan, .infinity, -.infinity, 1e300, 1e13, -1e13] {
+                let config = Config(events: [Event(at: Date()), Event(at: Date(timeIntervalSince1970: interval))])
+                do {
+                    _ = try encoder.encode(config)
+                    Issue.record("Expected an error for \(interval) with \(strategy)")
+                } catch TOMLEncodingError.invalidValue(_, let codingPath) {
+                    #expect(codingPath.map(\.stringValue) == ["events", "Index 1", "at"])
+                } catch {
+                    Issue.record("Unexpected error: \(error)")
+                }
+            }
+        }
+    }
+
+    @Test func swiftBackendWritesLastRepresentableDate() throws {
+        struct Event: Codable {
+            let at: Date
+        }
+
+        let encoder = TOMLEncoder()
+        let data = try encoder.encode(Event(at: Date(timeIntervalSince1970: 253_402_300_799)))
+        #expect(String(decoding: data, as: UTF8.self).contains("at = 9999-12-31T23:59:59.000Z"))
+
+        #expect(throws: TOMLEncodingError.self) {
+            _ = try encoder.encode(Event(at: Date(timeIntervalSince1970: 253_402_300_800)))
+        }
+    }
+
+    // MARK: - Converting JSON
+
+    @Test func tomlFromPlainJSON() throws {
+        let json = Data(#"{"name": "app", "port": 8080, "ratio": 0.5, "debug": null, "tags": ["a", "b"]}"#.utf8)
+        let toml = try TOMLEncoder().toml(fromJSON: json)
+
+        #expect(
+            try TOMLDecoder().decodeValue(from: toml)
+                == .table([
+                    "name": .string("app"),
+                    "port": .integer(8080),
+                    "ratio": .float(0.5),
+                    "tags": .array([.string("a"), .string("b")]),
+                ])
+        )
+    }
+
+    @Test func tomlFromTaggedJSON() throws {
+        let json = Data(
+            #"""
+            {"date": {"type": "date-local", "value": "2024-01-15"},
+             "server": {"port": {"value": "8080", "type": "integer"}},
+             "type": {"type": "string", "value": "tagged"}}
+            """#.utf8
+        )
+        let toml = try TOMLEncoder().toml(fromJSON: json, format: .tagged)
+
+        #expect(
+            try TOMLDecoder().decodeValue(from: toml)
+                == .table([
+                    "date": .localDate(LocalDate(year: 2024, month: 1, day: 15)),
+                    "server": .table(["port": .integer(8080)]),
+                    "type": .string("tagged"),
+                ])
+        )
+    }
+
+    @Test func tomlFromInvalidJSON() {
+        let encoder = TOMLEncoder()
+        #expect(throws: TOMLEncodingError.self) {
+            try encoder.toml(fromJSON: Data(#"{"a": [1, 2"#.utf8))
+        }
+        #expect(throws: TOMLEncodingError.self) {
+            try encoder.toml(fromJSON: Data("[1]".utf8))
+        }
+        #expect(throws: TOMLEncodingError.self) {
+            try encoder.toml(fromJSON: Data(#"{"a": {"type": "integer", "value": "x"}}"#.utf8), format: .tagged)
+        }
+    }
+
+    @Test func tomlFromJSONWithNullElements() {
+        let encoder = TOMLEncoder()
+        #expect(throws: TOMLEncodingError.self) {
+            try encoder.toml(fromJSON: Data(#"{"a": [1, null, 2]}"#.utf8))
+        }
+        #expect(throws: TOMLEncodingError.self) {
+            try encoder.toml(fromJSON: Data(#"{"a": [[null]]}"#.utf8))
+        }
+    }
+
+    @Test func tomlFromJSONWithLongNumbers() throws {
+        let digits = String(repeating: "0", count: 100)
+        let json = Data(#"{"ratio": 0.5\#(digits)1, "large": 1\#(digits)}"#.utf8)
+        let toml = try TOMLEncoder().toml(fromJSON: json)
+
+        #expect(try TOMLDecoder().decodeValue(from: toml) == .table(["ratio": .float(0.5), "large": .float(1e100)]))
+    }
+
+    // MARK: - Single-Pass Encoding
+
+    @Test func singlePassRoundTrips() throws {
+        struct Config: Codable, Equatable {
+            struct Owner: Codable, Equatable {
+                struct Contact: Codable, Equatable {
+                    let email: String
+                }
+                let name: String
+                let contact: Contact
+                let joined: LocalDate
+            }
+            struct Item: Codable, Equatable {
+                let id: Int
+                let tags: [String]
+            }
+            let title: String
+            let owner: Owner
+            let items: [Item]
+            let started: Date
+            let limits: [String: Int]
+            let version: Int
+        }
+
+        let config = Config(
+            title: "single pass",
+            owner: .init(
+                name: "Tom",
+                contact: .init(email: "tom@example.com"),
+                joined: LocalDate(year: 2013, month: 2, day: 24)
+            ),
+            items: [.init(id: 1, tags: ["a"]), .init(id: 2, tags: [])],
+            started: Date(timeIntervalSince1970: 296_638_320),
+            limits: ["cpu": 2],
+            version: 1
+        )
+
+        let encoder = TOMLEncoder()
+        encoder.encodingMode = .singlePass
+        let toml = try encoder.encodeToString(config)
+
+        #expect(try TOMLDecoder().decode(Config.self, from: toml) == config)
+        #expect(toml.contains("[owner]\nname = \"Tom\"\njoined = 2013-02-24\n\n[owner.contact]\n"))
+    }
+
+    @Test func singlePassWritesKeysBeforeSections() throws {
+        struct Config: Codable {
+            struct Server: Codable {
+                let host: String
+            }
+            let server: Server
+            let name: String
+        }
+
+        let encoder = TOMLEncoder()
+        encoder.encodingMode = .singlePass
+        let toml = try encoder.encodeToString(Config(server: .init(host: "a"), name: "x"))
+
+        #expect(toml == "name = \"x\"\n\n[server]\nhost = \"a\"\n")
+    }
+
+    @Test func singlePassToSink() throws {
+        let encoder = TOMLEncoder()
+        encoder.encodingMode = .singlePass
+        let sink = TOMLBytesSink()
+        try encoder.encode(Self.catalog, to: sink)
+
+        #expect(try TOMLDecoder().decode(Catalog.self, from: sink.bytes) == Self.catalog)
+    }
+
+    @Test func singlePassWithSortedKeysMatchesTree() throws {
+        struct Config: Codable {
+            let b: Int
+            let a: [String: String]
+        }
+        let config = Config(b: 1, a: ["y": "2", "x": "1"])
+
+        let encoder = TOMLEncoder()
+        encoder.outputFormatting = .sortedKeys
+        let tree = try encoder.encodeToString(config)
+        encoder.encodingMode = .singlePass
+
+        #expect(try encoder.encodeToString(config) == tree)
+    }
+
     // MARK: - User Info
 
     @Test func encoderUserInfo() throws {
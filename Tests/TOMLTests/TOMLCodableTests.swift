@@ -0,0 +1,218 @@
+import Foundation
+import Testing
+
+import TOML
+
+@Suite("TOMLCodable Tests")
+struct TOMLCodableTests {
+    struct Server: Codable, Equatable, TOMLCodable {
+        var host: String
+        var port: Int
+        var tags: [String]
+        var started: Date?
+        var decodedDirectly = false
+
+        enum CodingKeys: String, CodingKey {
+            case host, port, tags, started
+        }
+
+        init(host: String, port: Int, tags: [String], started: Date? = nil) {
+            self.host = host
+            self.port = port
+            self.tags = tags
+            self.started = started
+        }
+
+        init(toml table: TOMLDocument.Table) throws {
+            host = try table.decode(String.self, forKey: "host")
+            port = try table.decode(Int.self, forKey: "port")
+            tags = try table.decode([String].self, forKey: "tags")
+            started = try table.decodeIfPresent(Date.self, forKey: "started")
+            decodedDirectly = true
+        }
+
+        func encode(toml encoder: inout TOMLTableEncoder) throws {
+            try encoder.encode(host, forKey: "host")
+            try encoder.encode(port, forKey: "port")
+            try encoder.encode(tags, forKey: "tags")
+            try encoder.encodeIfPresent(started, forKey: "started")
+        }
+
+        static func == (lhs: Server, rhs: Server) -> Bool {
+            lhs.host == rhs.host && lhs.port == rhs.port && lhs.tags == rhs.tags && lhs.started == rhs.started
+        }
+    }
+
+    struct Config: Codable, Equatable {
+        var name: String
+        var servers: [Server]
+    }
+
+    @TOMLCodable
+    struct Endpoint: Codable, Equatable {
+        var path: String
+        var timeout: Double?
+        var retries: Int
+        let version = 1
+
+        enum CodingKeys: String, CodingKey {
+            case path
+            case timeout = "timeout-seconds"
+            case retries
+        }
+    }
+
+    // MARK: - Decoding
+
+    @Test func decoderUsesDirectInitializer() throws {
+        let toml = """
+            name = "cluster"
+
+            [[servers]]
+            host = "alpha"
+            port = 8080
+            tags = ["a", "b"]
+            started = 1979-05-27T07:32:00Z
+
+            [[servers]]
+            host = "beta"
+            port = 8081
+            tags = []
+            """
+
+        let config = try TOMLDecoder().decode(Config.self, from: toml)
+
+        #expect(config.name == "cluster")
+        #expect(config.servers.count == 2)
+        #expect(config.servers.allSatisfy(\.decodedDirectly))
+        let started = Date(timeIntervalSince1970: 296_638_320)
+        #expect(config.servers[0] == Server(host: "alpha", port: 8080, tags: ["a", "b"], started: started))
+        #expect(config.servers[1] == Server(host: "beta", port: 8081, tags: []))
+    }
+
+    @Test func directInitializerReportsErrors() throws {
+        let toml = """
+            host = "alpha"
+            port = "not a number"
+            tags = []
+            """
+
+        #expect(throws: DecodingError.self) {
+            try TOMLDecoder().decode(Server.self, from: toml)
+        }
+
+        #expect(throws: DecodingError.self) {
+            try TOMLDecoder().decode(Server.self, from: "host = \"alpha\"")
+        }
+    }
+
+    @Test func directInitializerReportsFullCodingPath() throws {
+        let mismatch = """
+            name = "cluster"
+            [[servers]]
+            host = "alpha"
+            port = 1
+            tags = []
+            [[servers]]
+            host = "beta"
+            port = "not a number"
+            tags = []
+            """
+
+        do {
+            _ = try TOMLDecoder().decode(Config.self, from: mismatch)
+            Issue.record("Expected a type mismatch")
+        } catch DecodingError.typeMismatch(_, let context) {
+            #expect(context.codingPath.map(\.stringValue) == ["servers", "Index 1", "port"])
+        }
+
+        do {
+            _ = try TOMLDecoder().decode(Config.self, from: "name = \"cluster\"\n[[servers]]\nport = 1")
+            Issue.record("Expected a missing key")
+        } catch DecodingError.keyNotFound(let key, let context) {
+            #expect(key.stringValue == "host")
+            #expect(context.codingPath.map(\.stringValue) == ["servers", "Index 0"])
+        }
+    }
+
+    @Test func documentTableDecoding() throws {
+        let document = try TOMLDocument(string: "[server]\nhost = \"alpha\"\nport = 1\ntags = [\"x\"]")
+        let table = try #require(document["server"]?.table)
+
+        let server = try Server(toml: table)
+
+        #expect(server == Server(host: "alpha", port: 1, tags: ["x"]))
+        #expect(try table.decodeIfPresent(Int.self, forKey: "missing") == nil)
+        #expect(try document["server"]?["port"]?.decode(Double.self) == 1.0)
+    }
+
+    // MARK: - Encoding
+
+    @Test func encoderUsesDirectEncoding() throws {
+        let config = Config(
+            name: "cluster",
+            servers: [
+                Server(host: "alpha", port: 8080, tags: ["a"], started: Date(timeIntervalSince1970: 296_638_320)),
+                Server(host: "beta", port: 8081, tags: []),
+            ]
+        )
+
+        let toml = try TOMLEncoder().encodeToString(config)
+        let decoded = try TOMLDecoder().decode(Config.self, from: toml)
+
+        #expect(decoded == config)
+        #expect(toml.contains("host = \"alpha\"\nport = 8080\ntags = [\"a\"]\nstarted = "))
+    }
+
+    @Test func directEncodingReportsFullCodingPath() throws {
+        struct Failing: Encodable {
+            func encode(to encoder: any Encoder) throws {
+                throw EncodingError.invalidValue(
+                    0,
+                    EncodingError.Context(codingPath: encoder.codingPath, debugDescription: "Always fails")
+                )
+            }
+        }
+
+        struct Holder: Encodable, TOMLEncodable {
+            let inner = Failing()
+
+            func encode(toml encoder: inout TOMLTableEncoder) throws {
+                try encoder.encode(inner, forKey: "inner")
+            }
+        }
+
+        struct Wrapper: Encodable {
+            let holders = [Holder()]
+        }
+
+        do {
+            _ = try TOMLEncoder().encode(Wrapper())
+            Issue.record("Expected an encoding error")
+        } catch EncodingError.invalidValue(_, let context) {
+            #expect(context.codingPath.map(\.stringValue) == ["holders", "Index 0", "inner"])
+        }
+    }
+
+    // MARK: - Macro
+
+    @Test func macroGeneratesConformances() throws {
+        #expect((Endpoint.self as Any.Type) is any TOMLCodable.Type)
+
+        let table = try TOMLDocument(string: "path = \"/a\"\ntimeout-seconds = 2.5\nretries = 3").root
+        #expect(try Endpoint(toml: table) == Endpoint(path: "/a", timeout: 2.5, retries: 3))
+
+        let endpoints = [Endpoint(path: "/a", timeout: nil, retries: 0), Endpoint(path: "/b", timeout: 1, retries: 2)]
+        let toml = try TOMLEncoder().encodeToString(["endpoints": endpoints])
+
+        #expect(toml.contains("path = \"/b\"\ntimeout-seconds = 1.0\nretries = 2"))
+        #expect(try TOMLDecoder().decode([String: [Endpoint]].self, from: toml) == ["endpoints": endpoints])
+    }
+
+    @Test func encodeTopLevelValue() throws {
+        let server = Server(host: "alpha", port: 8080, tags: [])
+        let toml = try TOMLEncoder().encodeToString(server)
+
+        #expect(toml == "host = \"alpha\"\nport = 8080\ntags = []\n")
+    }
+}
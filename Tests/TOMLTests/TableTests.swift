@@ -0,0 +1,71 @@
+import Testing
+
+import TOML
+
+@Suite("TOMLValue.Table Tests")
+struct TableTests {
+    @Test func preservesInsertionOrder() {
+        var table: TOMLValue.Table = ["b": .integer(2), "a": .integer(1)]
+        table["c"] = .integer(3)
+
+        #expect(table.keys == ["b", "a", "c"])
+        #expect(table.values == [.integer(2), .integer(1), .integer(3)])
+    }
+
+    @Test func replacingValueKeepsPosition() {
+        var table: TOMLValue.Table = ["a": .integer(1), "b": .integer(2)]
+        table["a"] = .integer(10)
+
+        #expect(table.keys == ["a", "b"])
+        #expect(table["a"] == .integer(10))
+    }
+
+    @Test func removingValues() {
+        var table: TOMLValue.Table = ["a": .integer(1), "b": .integer(2)]
+        table["a"] = nil
+
+        #expect(table.keys == ["b"])
+        #expect(table.removeValue(forKey: "b") == .integer(2))
+        #expect(table.removeValue(forKey: "b") == nil)
+        #expect(table.isEmpty)
+    }
+
+    @Test func largeTables() {
+        var table = TOMLValue.Table()
+        let count = TOMLValue.Table.indexThreshold * 4
+        for i in 0 ..< count {
+            table["key\(i)"] = .integer(Int64(i))
+        }
+
+        #expect(table.count == count)
+        #expect(table["key0"] == .integer(0))
+        #expect(table["key\(count - 1)"] == .integer(Int64(count - 1)))
+        #expect(table["missing"] == nil)
+
+        for i in stride(from: 0, to: count, by: 2) {
+            table["key\(i)"] = nil
+        }
+
+        #expect(table.count == count / 2)
+        #expect(table["key0"] == nil)
+        #expect(table["key1"] == .integer(1))
+        #expect(table.keys.first == "key1")
+    }
+
+    @Test func equalityIgnoresOrder() {
+        let lhs: TOMLValue.Table = ["a": .integer(1), "b": .integer(2)]
+        let rhs: TOMLValue.Table = ["b": .integer(2), "a": .integer(1)]
+
+        #expect(lhs == rhs)
+        #expect(lhs != ["a": .integer(1)])
+        #expect(lhs != ["a": .integer(1), "b": .integer(3)])
+    }
+
+    @Test func dictionaryConversion() {
+        let dictionary: [String: TOMLValue] = ["a": .integer(1), "b": .string("two")]
+        let table = TOMLValue.Table(dictionary)
+
+        #expect(table.count == 2)
+        #expect(table.dictionary == dictionary)
+    }
+}